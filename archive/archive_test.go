@@ -0,0 +1,294 @@
+package archive
+
+import (
+	"bytes"
+	"encoding/hex"
+	"errors"
+	"fmt"
+	"path/filepath"
+	"reflect"
+	"strings"
+	"testing"
+
+	"github.com/elliottech/lighter-go/types/txtypes"
+)
+
+func archiveTestSig(seed byte) ([]byte, string) {
+	sig, hash := make([]byte, SigSize), make([]byte, HashSize)
+	for i := range sig {
+		sig[i] = seed + byte(i)
+	}
+	for i := range hash {
+		hash[i] = seed ^ byte(i)
+	}
+	return sig, hex.EncodeToString(hash)
+}
+
+func archiveTestTxs() []txtypes.TxInfo {
+	sig1, hash1 := archiveTestSig(1)
+	sig2, hash2 := archiveTestSig(2)
+	sig3, hash3 := archiveTestSig(3)
+	sig4, hash4 := archiveTestSig(4)
+	return []txtypes.TxInfo{
+		&txtypes.L2CreateOrderTxInfo{
+			AccountIndex: 281474976710655,
+			ApiKeyIndex:  3,
+			OrderInfo: &txtypes.OrderInfo{
+				MarketIndex:      12,
+				ClientOrderIndex: 77,
+				BaseAmount:       1_000_000,
+				Price:            4_200_000,
+				IsAsk:            1,
+				Type:             txtypes.LimitOrder,
+				TimeInForce:      txtypes.GoodTillTime,
+				TriggerPrice:     4_100_000,
+				OrderExpiry:      1_760_000_000_000,
+			},
+			ExpiredAt:  1_750_000_000_000,
+			Nonce:      41,
+			Sig:        sig1,
+			SignedHash: hash1,
+			L2TxAttributes: txtypes.L2TxAttributes{
+				txtypes.AttributeTypeIntegratorAccountIndex: 9,
+				txtypes.AttributeTypeIntegratorTakerFee:     100,
+				txtypes.AttributeTypeIntegratorMakerFee:     50,
+			},
+		},
+		&txtypes.L2ModifyOrderTxInfo{
+			AccountIndex: 281474976710655,
+			ApiKeyIndex:  3,
+			MarketIndex:  12,
+			Index:        77,
+			BaseAmount:   2_000_000,
+			Price:        4_300_000,
+			ExpiredAt:    1_750_000_000_500,
+			Nonce:        42,
+			Sig:          sig2,
+			SignedHash:   hash2,
+		},
+		&txtypes.L2CancelOrderTxInfo{
+			AccountIndex:   281474976710655,
+			ApiKeyIndex:    3,
+			MarketIndex:    12,
+			Index:          77,
+			ExpiredAt:      1_750_000_001_000,
+			Nonce:          -1,
+			Sig:            sig3,
+			SignedHash:     hash3,
+			L2TxAttributes: txtypes.L2TxAttributes{txtypes.AttributeTypeSkipTxNonce: 1},
+		},
+		&txtypes.L2CancelAllOrdersTxInfo{
+			AccountIndex: 281474976710655,
+			ApiKeyIndex:  3,
+			TimeInForce:  txtypes.ScheduledCancelAll,
+			Time:         1_750_000_600_000,
+			ExpiredAt:    1_750_000_002_000,
+			Nonce:        43,
+			Sig:          sig4,
+			SignedHash:   hash4,
+		},
+	}
+}
+
+func TestArchiveRoundTrip(t *testing.T) {
+	path := filepath.Join(t.TempDir(), "txs.ltxa")
+	w, err := Create(path, WriterConfig{BlockRows: 3})
+	if err != nil {
+		t.Fatal(err)
+	}
+	txs := archiveTestTxs()
+	for _, tx := range txs {
+		if err := w.Append(tx); err != nil {
+			t.Fatal(err)
+		}
+	}
+	if err := w.Append(&txtypes.L2WithdrawTxInfo{}); !errors.Is(err, ErrUnsupportedTx) {
+		t.Errorf("err = %v, want ErrUnsupportedTx", err)
+	}
+
+	// full blocks reach the file before Close
+	r, err := Open(path)
+	if err != nil {
+		t.Fatal(err)
+	}
+	if r.Blocks() != 1 || r.Rows() != 3 {
+		t.Errorf("before Close: rows = %d, blocks = %d", r.Rows(), r.Blocks())
+	}
+	r.Close()
+
+	if err := w.Close(); err != nil {
+		t.Fatal(err)
+	}
+
+	r, err = Open(path)
+	if err != nil {
+		t.Fatal(err)
+	}
+	defer r.Close()
+	if r.Rows() != len(txs) || r.Blocks() != 2 || r.Truncated() {
+		t.Fatalf("rows = %d, blocks = %d, truncated = %v", r.Rows(), r.Blocks(), r.Truncated())
+	}
+	i := 0
+	err = r.Scan(nil, func(row *Row) bool {
+		tx, err := row.TxInfo()
+		if err != nil {
+			t.Fatal(err)
+		}
+		if !reflect.DeepEqual(tx, txs[i]) {
+			t.Errorf("row %d = %+v, want %+v", i, tx, txs[i])
+		}
+		i++
+		return true
+	})
+	if err != nil || i != len(txs) {
+		t.Fatalf("scanned %d rows, err = %v", i, err)
+	}
+}
+
+func TestArchiveScanFilter(t *testing.T) {
+	var buf bytes.Buffer
+	w, err := NewWriter(&buf, WriterConfig{BlockRows: 100})
+	if err != nil {
+		t.Fatal(err)
+	}
+	for i := int64(0); i < 1000; i++ {
+		err := w.Append(&txtypes.L2CancelOrderTxInfo{AccountIndex: 1, MarketIndex: int16(i % 4), Index: i, Nonce: i})
+		if err != nil {
+			t.Fatal(err)
+		}
+	}
+	if err := w.Flush(); err != nil {
+		t.Fatal(err)
+	}
+
+	// an incomplete last block is ignored
+	data := append(bytes.Clone(buf.Bytes()), buf.Bytes()[len(fileMagic):len(fileMagic)+100]...)
+	r, err := NewReader(data)
+	if err != nil {
+		t.Fatal(err)
+	}
+	if r.Rows() != 1000 || !r.Truncated() {
+		t.Fatalf("rows = %d, truncated = %v", r.Rows(), r.Truncated())
+	}
+
+	var nonces []int64
+	ranges := []Range{{Column: ColNonce, Min: 250, Max: 269}, {Column: ColMarketIndex, Min: 1, Max: 2}}
+	if err := r.Scan(ranges, func(row *Row) bool {
+		nonces = append(nonces, row.Nonce)
+		return true
+	}); err != nil {
+		t.Fatal(err)
+	}
+	if want := []int64{250, 253, 254, 257, 258, 261, 262, 265, 266, 269}; fmt.Sprint(nonces) != fmt.Sprint(want) {
+		t.Errorf("nonces = %v, want %v", nonces, want)
+	}
+
+	if err := r.Scan([]Range{{Column: numIntColumns}}, func(*Row) bool { return true }); !errors.Is(err, ErrUnknownColumn) {
+		t.Errorf("err = %v, want ErrUnknownColumn", err)
+	}
+}
+
+func TestConvertNDJSON(t *testing.T) {
+	var lines []string
+	for _, tx := range archiveTestTxs() {
+		info, err := tx.GetTxInfo()
+		if err != nil {
+			t.Fatal(err)
+		}
+		lines = append(lines, info)
+	}
+	// as sent to sendTx, and a tx type which isn't archived
+	lines = append(lines, fmt.Sprintf(`{"tx_type":%d,"tx_info":%q}`, txtypes.TxTypeL2CancelOrder, lines[2]), "", `{"tx_type":13,"tx_info":"{}"}`)
+
+	var buf bytes.Buffer
+	w, err := NewWriter(&buf, WriterConfig{})
+	if err != nil {
+		t.Fatal(err)
+	}
+	converted, skipped, err := ConvertNDJSON(strings.NewReader(strings.Join(lines, "\n")), w)
+	if err != nil || converted != 5 || skipped != 1 {
+		t.Fatalf("converted = %d, skipped = %d, err = %v", converted, skipped, err)
+	}
+	if err := w.Flush(); err != nil {
+		t.Fatal(err)
+	}
+	r, err := NewReader(buf.Bytes())
+	if err != nil {
+		t.Fatal(err)
+	}
+	var types []uint8
+	if err := r.Scan(nil, func(row *Row) bool {
+		types = append(types, row.TxType)
+		return true
+	}); err != nil {
+		t.Fatal(err)
+	}
+	want := []uint8{txtypes.TxTypeL2CreateOrder, txtypes.TxTypeL2ModifyOrder, txtypes.TxTypeL2CancelOrder, txtypes.TxTypeL2CancelAllOrders, txtypes.TxTypeL2CancelOrder}
+	if !reflect.DeepEqual(types, want) {
+		t.Errorf("tx types = %v, want %v", types, want)
+	}
+
+	_, _, err = ConvertNDJSON(strings.NewReader("{}\nnot json"), w)
+	if err == nil || !strings.Contains(err.Error(), "line 2") {
+		t.Errorf("err = %v, want an error on line 2", err)
+	}
+}
+
+// BenchmarkArchiveScan reports rows/s of a full scan, and of a scan filtered on one market over a time range
+func BenchmarkArchiveScan(b *testing.B) {
+	const rows = 1 << 20
+	var buf bytes.Buffer
+	w, err := NewWriter(&buf, WriterConfig{})
+	if err != nil {
+		b.Fatal(err)
+	}
+	sig, hash := archiveTestSig(0)
+	for i := int64(0); i < rows; i++ {
+		err := w.Append(&txtypes.L2CreateOrderTxInfo{
+			AccountIndex: 100 + i%8,
+			OrderInfo: &txtypes.OrderInfo{
+				MarketIndex:      int16(i % 16),
+				ClientOrderIndex: i,
+				BaseAmount:       1000 + i%100,
+				Price:            uint32(4_000_000 + i%1000),
+				IsAsk:            uint8(i % 2),
+			},
+			ExpiredAt:  1_750_000_000_000 + i,
+			Nonce:      i / 8,
+			Sig:        sig,
+			SignedHash: hash,
+		})
+		if err != nil {
+			b.Fatal(err)
+		}
+	}
+	if err := w.Flush(); err != nil {
+		b.Fatal(err)
+	}
+	r, err := NewReader(buf.Bytes())
+	if err != nil {
+		b.Fatal(err)
+	}
+	b.Logf("%d rows, %.1f bytes/row", rows, float64(buf.Len())/rows)
+
+	for _, bench := range []struct {
+		name   string
+		ranges []Range
+	}{
+		{"full", nil},
+		{"filtered", []Range{{Column: ColMarketIndex, Min: 3, Max: 3}, {Column: ColExpiredAt, Min: 1_750_000_000_000 + rows/4, Max: 1_750_000_000_000 + rows/2}}},
+	} {
+		b.Run(bench.name, func(b *testing.B) {
+			var volume int64
+			for i := 0; i < b.N; i++ {
+				if err := r.Scan(bench.ranges, func(row *Row) bool {
+					volume += row.BaseAmount
+					return true
+				}); err != nil {
+					b.Fatal(err)
+				}
+			}
+			b.ReportMetric(float64(rows)*float64(b.N)/b.Elapsed().Seconds(), "rows/s")
+		})
+	}
+}
@@ -0,0 +1,197 @@
+// Package archive stores signed order-flow transactions in a columnar file, for analytics over large tx logs.
+//
+// A file is a header followed by self-contained blocks of up to WriterConfig.BlockRows txs, appended as they fill up,
+// so an archive can be read while it's being written and a crash only loses the block in progress.
+// Within a block, every field is a column: integers are stored as constants, zigzag varints or zigzag varint deltas
+// (whichever is smallest) with their min & max, so scans can skip blocks, and the tx hash & signature are stored as
+// fixed-width byte columns which are read in place from the memory-mapped file.
+package archive
+
+import (
+	"encoding/binary"
+	"errors"
+)
+
+var (
+	ErrUnsupportedTx = errors.New("archive only stores CreateOrder, ModifyOrder, CancelOrder & CancelAllOrders txs")
+	ErrCorrupted     = errors.New("archive is corrupted")
+	ErrUnknownColumn = errors.New("scan ranges can only filter integer columns")
+)
+
+// Column is an integer column of the archive, used to filter scans
+type Column uint8
+
+const (
+	ColTxType Column = iota
+	ColAccountIndex
+	ColApiKeyIndex
+	ColMarketIndex
+	// ColIndex is the ClientOrderIndex of CreateOrder txs, and the Index of the order of ModifyOrder & CancelOrder txs
+	ColIndex
+	ColBaseAmount
+	ColPrice
+	ColIsAsk
+	ColOrderType
+	ColTimeInForce
+	ColReduceOnly
+	ColTriggerPrice
+	ColOrderExpiry
+	// ColTime is the Time of CancelAllOrders txs
+	ColTime
+	ColExpiredAt
+	ColNonce
+	ColSkipNonce
+	ColIntegratorAccountIndex
+	ColIntegratorTakerFee
+	ColIntegratorMakerFee
+
+	numIntColumns
+)
+
+// Byte columns, after the integer ones
+const (
+	colHash = numIntColumns + iota
+	colSig
+
+	numColumns
+)
+
+const (
+	// HashSize is the size of the signed hash, the 40 bytes encoded in hex by GetTxHash
+	HashSize = 40
+	// SigSize is the size of a Schnorr signature
+	SigSize = 80
+)
+
+// column encodings
+const (
+	encConst uint8 = iota
+	encVarint
+	encDelta
+	encFixed
+)
+
+var (
+	fileMagic  = [8]byte{'L', 'T', 'X', 'A', 0, 0, 0, 1}
+	blockMagic = uint32(0x4b4c4258) // "XBLK"
+)
+
+const (
+	// magic, length of the block after the header, rows, columns
+	blockHeaderSize = 4 + 4 + 4 + 4
+	// column, encoding, min, max, offset & length of the data within the block
+	columnEntrySize = 1 + 1 + 8 + 8 + 4 + 4
+)
+
+// Row is a tx read from an archive. Fields which don't apply to the tx type are 0.
+// Hash & Sig point into the archive and are only valid until it's closed.
+type Row struct {
+	TxType                 uint8
+	AccountIndex           int64
+	ApiKeyIndex            uint8
+	MarketIndex            int16
+	Index                  int64
+	BaseAmount             int64
+	Price                  uint32
+	IsAsk                  uint8
+	OrderType              uint8
+	TimeInForce            uint8
+	ReduceOnly             uint8
+	TriggerPrice           uint32
+	OrderExpiry            int64
+	Time                   int64
+	ExpiredAt              int64
+	Nonce                  int64
+	SkipNonce              uint8
+	IntegratorAccountIndex int64
+	IntegratorTakerFee     uint32
+	IntegratorMakerFee     uint32
+
+	Hash []byte
+	Sig  []byte
+}
+
+func (row *Row) set(values *[numIntColumns]int64) {
+	row.TxType = uint8(values[ColTxType])
+	row.AccountIndex = values[ColAccountIndex]
+	row.ApiKeyIndex = uint8(values[ColApiKeyIndex])
+	row.MarketIndex = int16(values[ColMarketIndex])
+	row.Index = values[ColIndex]
+	row.BaseAmount = values[ColBaseAmount]
+	row.Price = uint32(values[ColPrice])
+	row.IsAsk = uint8(values[ColIsAsk])
+	row.OrderType = uint8(values[ColOrderType])
+	row.TimeInForce = uint8(values[ColTimeInForce])
+	row.ReduceOnly = uint8(values[ColReduceOnly])
+	row.TriggerPrice = uint32(values[ColTriggerPrice])
+	row.OrderExpiry = values[ColOrderExpiry]
+	row.Time = values[ColTime]
+	row.ExpiredAt = values[ColExpiredAt]
+	row.Nonce = values[ColNonce]
+	row.SkipNonce = uint8(values[ColSkipNonce])
+	row.IntegratorAccountIndex = values[ColIntegratorAccountIndex]
+	row.IntegratorTakerFee = uint32(values[ColIntegratorTakerFee])
+	row.IntegratorMakerFee = uint32(values[ColIntegratorMakerFee])
+}
+
+func zigzag(v int64) uint64 {
+	return uint64(v<<1) ^ uint64(v>>63)
+}
+
+func unzigzag(u uint64) int64 {
+	return int64(u>>1) ^ -int64(u&1)
+}
+
+// encodeInts appends the smallest encoding of values to dst
+func encodeInts(dst []byte, values []int64) (out []byte, enc uint8, minV, maxV int64) {
+	minV, maxV = values[0], values[0]
+	for _, v := range values[1:] {
+		minV, maxV = min(minV, v), max(maxV, v)
+	}
+	if minV == maxV {
+		return dst, encConst, minV, maxV
+	}
+
+	start := len(dst)
+	for _, v := range values {
+		dst = binary.AppendUvarint(dst, zigzag(v))
+	}
+	varintEnd := len(dst)
+	prev := int64(0)
+	for _, v := range values {
+		dst = binary.AppendUvarint(dst, zigzag(v-prev))
+		prev = v
+	}
+	if len(dst)-varintEnd < varintEnd-start {
+		return append(dst[:start], dst[varintEnd:]...), encDelta, minV, maxV
+	}
+	return dst[:varintEnd], encVarint, minV, maxV
+}
+
+// decodeInts fills values from a column of len(values) rows
+func decodeInts(values []int64, data []byte, enc uint8, minV int64) error {
+	switch enc {
+	case encConst:
+		for i := range values {
+			values[i] = minV
+		}
+		return nil
+	case encVarint, encDelta:
+		prev := int64(0)
+		for i := range values {
+			u, n := binary.Uvarint(data)
+			if n <= 0 {
+				return ErrCorrupted
+			}
+			data = data[n:]
+			v := unzigzag(u)
+			if enc == encDelta {
+				v += prev
+				prev = v
+			}
+			values[i] = v
+		}
+		return nil
+	}
+	return ErrCorrupted
+}
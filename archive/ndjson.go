@@ -0,0 +1,101 @@
+package archive
+
+import (
+	"bufio"
+	"encoding/json"
+	"errors"
+	"fmt"
+	"io"
+
+	"github.com/elliottech/lighter-go/types/txtypes"
+)
+
+// ParseTxInfo parses the JSON txInfo of a supported tx type, as returned by TxInfo.GetTxInfo
+func ParseTxInfo(txType uint8, txInfo []byte) (txtypes.TxInfo, error) {
+	var tx txtypes.TxInfo
+	switch txType {
+	case txtypes.TxTypeL2CreateOrder:
+		tx = &txtypes.L2CreateOrderTxInfo{}
+	case txtypes.TxTypeL2ModifyOrder:
+		tx = &txtypes.L2ModifyOrderTxInfo{}
+	case txtypes.TxTypeL2CancelOrder:
+		tx = &txtypes.L2CancelOrderTxInfo{}
+	case txtypes.TxTypeL2CancelAllOrders:
+		tx = &txtypes.L2CancelAllOrdersTxInfo{}
+	default:
+		return nil, fmt.Errorf("%w, got tx type %d", ErrUnsupportedTx, txType)
+	}
+	if err := json.Unmarshal(txInfo, tx); err != nil {
+		return nil, err
+	}
+	return tx, nil
+}
+
+// inferTxType guesses the type of a bare txInfo from the fields only that type has
+func inferTxType(fields map[string]json.RawMessage) (uint8, bool) {
+	has := func(name string) bool {
+		_, ok := fields[name]
+		return ok
+	}
+	switch {
+	case has("OrderExpiry"):
+		return txtypes.TxTypeL2CreateOrder, true
+	case has("Time"):
+		return txtypes.TxTypeL2CancelAllOrders, true
+	case has("Index") && has("Price"):
+		return txtypes.TxTypeL2ModifyOrder, true
+	case has("Index"):
+		return txtypes.TxTypeL2CancelOrder, true
+	}
+	return 0, false
+}
+
+// ConvertNDJSON appends the txs of an NDJSON log to w. Every line is either a bare txInfo object, whose type is
+// inferred from its fields, or {"tx_type": ..., "tx_info": "..."} as sent to the sendTx endpoint.
+// Lines with other tx types are skipped and counted. The first invalid line stops the conversion.
+func ConvertNDJSON(in io.Reader, w *Writer) (converted, skipped int, err error) {
+	scanner := bufio.NewScanner(in)
+	scanner.Buffer(make([]byte, 0, 64*1024), 16*1024*1024)
+	for line := 1; scanner.Scan(); line++ {
+		text := scanner.Bytes()
+		if len(text) == 0 {
+			continue
+		}
+		var fields map[string]json.RawMessage
+		if err := json.Unmarshal(text, &fields); err != nil {
+			return converted, skipped, fmt.Errorf("line %d: %w", line, err)
+		}
+
+		var (
+			txType uint8
+			txInfo = text
+		)
+		if rawType, ok := fields["tx_type"]; ok {
+			var info string
+			if err := json.Unmarshal(rawType, &txType); err != nil {
+				return converted, skipped, fmt.Errorf("line %d: tx_type: %w", line, err)
+			}
+			if err := json.Unmarshal(fields["tx_info"], &info); err != nil {
+				return converted, skipped, fmt.Errorf("line %d: tx_info: %w", line, err)
+			}
+			txInfo = []byte(info)
+		} else if txType, ok = inferTxType(fields); !ok {
+			skipped++
+			continue
+		}
+
+		tx, err := ParseTxInfo(txType, txInfo)
+		if err == nil {
+			err = w.Append(tx)
+		}
+		switch {
+		case errors.Is(err, ErrUnsupportedTx):
+			skipped++
+		case err != nil:
+			return converted, skipped, fmt.Errorf("line %d: %w", line, err)
+		default:
+			converted++
+		}
+	}
+	return converted, skipped, scanner.Err()
+}
@@ -0,0 +1,312 @@
+package archive
+
+import (
+	"bytes"
+	"encoding/binary"
+	"encoding/hex"
+	"fmt"
+
+	"github.com/elliottech/lighter-go/types/txtypes"
+)
+
+// Range keeps the rows whose Column is within [Min, Max]
+type Range struct {
+	Column   Column
+	Min, Max int64
+}
+
+type columnInfo struct {
+	enc        uint8
+	minV, maxV int64
+	data       []byte
+}
+
+type blockInfo struct {
+	rows int
+	cols [numColumns]columnInfo
+}
+
+// Reader scans an archive. Open memory-maps the file, so only the columns & blocks a scan needs are paged in.
+type Reader struct {
+	data      []byte
+	unmap     func() error
+	blocks    []blockInfo
+	rows      int
+	truncated bool
+}
+
+func Open(path string) (*Reader, error) {
+	data, unmap, err := mapFile(path)
+	if err != nil {
+		return nil, err
+	}
+	r, err := NewReader(data)
+	if err != nil {
+		_ = unmap()
+		return nil, err
+	}
+	r.unmap = unmap
+	return r, nil
+}
+
+// NewReader reads an archive held in memory. An incomplete last block (archive being written, or crash) is ignored.
+func NewReader(data []byte) (*Reader, error) {
+	if len(data) < len(fileMagic) || !bytes.Equal(data[:len(fileMagic)], fileMagic[:]) {
+		return nil, fmt.Errorf("%w: not an archive", ErrCorrupted)
+	}
+	r := &Reader{data: data}
+	for rest := data[len(fileMagic):]; len(rest) > 0; {
+		if len(rest) < blockHeaderSize {
+			r.truncated = true
+			break
+		}
+		if binary.LittleEndian.Uint32(rest[0:]) != blockMagic {
+			return nil, fmt.Errorf("%w: bad block magic at offset %d", ErrCorrupted, len(data)-len(rest))
+		}
+		length := int(binary.LittleEndian.Uint32(rest[4:]))
+		rows := int(binary.LittleEndian.Uint32(rest[8:]))
+		nCols := int(binary.LittleEndian.Uint32(rest[12:]))
+		if len(rest)-blockHeaderSize < length {
+			r.truncated = true
+			break
+		}
+		block, err := parseBlock(rest[blockHeaderSize:blockHeaderSize+length], rows, nCols)
+		if err != nil {
+			return nil, err
+		}
+		r.blocks = append(r.blocks, block)
+		r.rows += rows
+		rest = rest[blockHeaderSize+length:]
+	}
+	return r, nil
+}
+
+func parseBlock(b []byte, rows, nCols int) (blockInfo, error) {
+	block := blockInfo{rows: rows}
+	if nCols*columnEntrySize > len(b) {
+		return block, ErrCorrupted
+	}
+	data := b[nCols*columnEntrySize:]
+	for i := 0; i < nCols; i++ {
+		e := b[i*columnEntrySize:]
+		col, enc := Column(e[0]), e[1]
+		offset := int(binary.LittleEndian.Uint32(e[18:]))
+		length := int(binary.LittleEndian.Uint32(e[22:]))
+		if offset+length > len(data) {
+			return block, ErrCorrupted
+		}
+		if col >= numColumns {
+			// added by a later version
+			continue
+		}
+		block.cols[col] = columnInfo{
+			enc:  enc,
+			minV: int64(binary.LittleEndian.Uint64(e[2:])),
+			maxV: int64(binary.LittleEndian.Uint64(e[10:])),
+			data: data[offset : offset+length],
+		}
+	}
+	if len(block.cols[colHash].data) != rows*HashSize || len(block.cols[colSig].data) != rows*SigSize {
+		return block, ErrCorrupted
+	}
+	return block, nil
+}
+
+func (r *Reader) Rows() int {
+	return r.rows
+}
+
+func (r *Reader) Blocks() int {
+	return len(r.blocks)
+}
+
+// Truncated reports whether the archive ends with an incomplete block, which is ignored
+func (r *Reader) Truncated() bool {
+	return r.truncated
+}
+
+func (r *Reader) Close() error {
+	if r.unmap == nil {
+		return nil
+	}
+	unmap := r.unmap
+	r.unmap, r.data, r.blocks = nil, nil, nil
+	return unmap()
+}
+
+// Scan calls fn, in archive order, for every row within all the ranges, until fn returns false.
+// Blocks whose min & max rule out a range are skipped without being decoded, and the columns of the ranges
+// are decoded first so the others are only decoded for blocks with matching rows.
+// row is reused between calls. A range over a column which isn't one of the Col* constants fails with ErrUnknownColumn.
+func (r *Reader) Scan(ranges []Range, fn func(row *Row) bool) error {
+	for _, rg := range ranges {
+		if rg.Column >= numIntColumns {
+			return fmt.Errorf("column %d: %w", rg.Column, ErrUnknownColumn)
+		}
+	}
+
+	var (
+		values  [numIntColumns][]int64
+		decoded [numIntColumns]bool
+		sel     []int32
+		row     Row
+		rowVals [numIntColumns]int64
+	)
+blocks:
+	for _, block := range r.blocks {
+		for _, rg := range ranges {
+			col := block.cols[rg.Column]
+			if col.maxV < rg.Min || col.minV > rg.Max {
+				continue blocks
+			}
+		}
+
+		decode := func(c Column) error {
+			if decoded[c] {
+				return nil
+			}
+			if cap(values[c]) < block.rows {
+				values[c] = make([]int64, block.rows)
+			}
+			values[c] = values[c][:block.rows]
+			decoded[c] = true
+			col := block.cols[c]
+			return decodeInts(values[c], col.data, col.enc, col.minV)
+		}
+		decoded = [numIntColumns]bool{}
+
+		sel = sel[:0]
+		for i := 0; i < block.rows; i++ {
+			sel = append(sel, int32(i))
+		}
+		for _, rg := range ranges {
+			col := block.cols[rg.Column]
+			if col.minV >= rg.Min && col.maxV <= rg.Max {
+				continue
+			}
+			if err := decode(rg.Column); err != nil {
+				return err
+			}
+			kept := sel[:0]
+			for _, i := range sel {
+				if v := values[rg.Column][i]; v >= rg.Min && v <= rg.Max {
+					kept = append(kept, i)
+				}
+			}
+			sel = kept
+		}
+		if len(sel) == 0 {
+			continue
+		}
+
+		for c := Column(0); c < numIntColumns; c++ {
+			if err := decode(c); err != nil {
+				return err
+			}
+		}
+		hashes, sigs := block.cols[colHash].data, block.cols[colSig].data
+		for _, i := range sel {
+			for c := range rowVals {
+				rowVals[c] = values[c][i]
+			}
+			row.set(&rowVals)
+			row.Hash = hashes[int(i)*HashSize : int(i+1)*HashSize : int(i+1)*HashSize]
+			row.Sig = sigs[int(i)*SigSize : int(i+1)*SigSize : int(i+1)*SigSize]
+			if !fn(&row) {
+				return nil
+			}
+		}
+	}
+	return nil
+}
+
+// TxInfo rebuilds the tx of a row. Its hash is only set if it was archived.
+func (row *Row) TxInfo() (txtypes.TxInfo, error) {
+	var attrs txtypes.L2TxAttributes
+	for typ, v := range map[uint8]int64{
+		txtypes.AttributeTypeIntegratorAccountIndex: row.IntegratorAccountIndex,
+		txtypes.AttributeTypeIntegratorTakerFee:     int64(row.IntegratorTakerFee),
+		txtypes.AttributeTypeIntegratorMakerFee:     int64(row.IntegratorMakerFee),
+		txtypes.AttributeTypeSkipTxNonce:            int64(row.SkipNonce),
+	} {
+		if v != 0 {
+			if attrs == nil {
+				attrs = txtypes.L2TxAttributes{}
+			}
+			attrs[typ] = int(v)
+		}
+	}
+	var sig []byte
+	if !bytes.Equal(row.Sig, make([]byte, SigSize)) {
+		sig = bytes.Clone(row.Sig)
+	}
+	var signedHash string
+	if !bytes.Equal(row.Hash, make([]byte, HashSize)) {
+		signedHash = hex.EncodeToString(row.Hash)
+	}
+
+	switch row.TxType {
+	case txtypes.TxTypeL2CreateOrder:
+		return &txtypes.L2CreateOrderTxInfo{
+			AccountIndex: row.AccountIndex,
+			ApiKeyIndex:  row.ApiKeyIndex,
+			OrderInfo: &txtypes.OrderInfo{
+				MarketIndex:      row.MarketIndex,
+				ClientOrderIndex: row.Index,
+				BaseAmount:       row.BaseAmount,
+				Price:            row.Price,
+				IsAsk:            row.IsAsk,
+				Type:             row.OrderType,
+				TimeInForce:      row.TimeInForce,
+				ReduceOnly:       row.ReduceOnly,
+				TriggerPrice:     row.TriggerPrice,
+				OrderExpiry:      row.OrderExpiry,
+			},
+			ExpiredAt:      row.ExpiredAt,
+			Nonce:          row.Nonce,
+			Sig:            sig,
+			SignedHash:     signedHash,
+			L2TxAttributes: attrs,
+		}, nil
+	case txtypes.TxTypeL2ModifyOrder:
+		return &txtypes.L2ModifyOrderTxInfo{
+			AccountIndex:   row.AccountIndex,
+			ApiKeyIndex:    row.ApiKeyIndex,
+			MarketIndex:    row.MarketIndex,
+			Index:          row.Index,
+			BaseAmount:     row.BaseAmount,
+			Price:          row.Price,
+			TriggerPrice:   row.TriggerPrice,
+			ExpiredAt:      row.ExpiredAt,
+			Nonce:          row.Nonce,
+			Sig:            sig,
+			SignedHash:     signedHash,
+			L2TxAttributes: attrs,
+		}, nil
+	case txtypes.TxTypeL2CancelOrder:
+		return &txtypes.L2CancelOrderTxInfo{
+			AccountIndex:   row.AccountIndex,
+			ApiKeyIndex:    row.ApiKeyIndex,
+			MarketIndex:    row.MarketIndex,
+			Index:          row.Index,
+			ExpiredAt:      row.ExpiredAt,
+			Nonce:          row.Nonce,
+			Sig:            sig,
+			SignedHash:     signedHash,
+			L2TxAttributes: attrs,
+		}, nil
+	case txtypes.TxTypeL2CancelAllOrders:
+		return &txtypes.L2CancelAllOrdersTxInfo{
+			AccountIndex:   row.AccountIndex,
+			ApiKeyIndex:    row.ApiKeyIndex,
+			TimeInForce:    row.TimeInForce,
+			Time:           row.Time,
+			ExpiredAt:      row.ExpiredAt,
+			Nonce:          row.Nonce,
+			Sig:            sig,
+			SignedHash:     signedHash,
+			L2TxAttributes: attrs,
+		}, nil
+	}
+	return nil, fmt.Errorf("%w, got tx type %d", ErrUnsupportedTx, row.TxType)
+}
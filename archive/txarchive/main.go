@@ -0,0 +1,90 @@
+// Command txarchive converts NDJSON txInfo logs into an archive, and prints a summary of an archive.
+//
+//	txarchive [-chain-id N] [-block-rows N] -o txs.ltxa log1.ndjson [log2.ndjson ...]   (- or no log reads stdin)
+//	txarchive -stat txs.ltxa
+package main
+
+import (
+	"flag"
+	"fmt"
+	"io"
+	"os"
+
+	"github.com/elliottech/lighter-go/archive"
+)
+
+func main() {
+	var (
+		out       = flag.String("o", "", "archive to create")
+		stat      = flag.String("stat", "", "archive to summarize")
+		chainId   = flag.Uint("chain-id", 0, "chain id used to compute the hash of the txs, if 0 hashes are stored as zeroes")
+		blockRows = flag.Int("block-rows", 0, "txs per block, defaults to 65536")
+	)
+	flag.Parse()
+
+	var err error
+	switch {
+	case *stat != "":
+		err = summarize(*stat)
+	case *out != "":
+		err = convert(*out, archive.WriterConfig{BlockRows: *blockRows, ChainId: uint32(*chainId)}, flag.Args())
+	default:
+		flag.Usage()
+		os.Exit(2)
+	}
+	if err != nil {
+		fmt.Fprintln(os.Stderr, "txarchive:", err)
+		os.Exit(1)
+	}
+}
+
+func convert(path string, cfg archive.WriterConfig, logs []string) error {
+	w, err := archive.Create(path, cfg)
+	if err != nil {
+		return err
+	}
+	if len(logs) == 0 {
+		logs = []string{"-"}
+	}
+	for _, log := range logs {
+		var in io.ReadCloser = os.Stdin
+		if log != "-" {
+			if in, err = os.Open(log); err != nil {
+				_ = w.Close()
+				return err
+			}
+		}
+		converted, skipped, err := archive.ConvertNDJSON(in, w)
+		_ = in.Close()
+		if err != nil {
+			_ = w.Close()
+			return fmt.Errorf("%s: %w", log, err)
+		}
+		fmt.Printf("%s: %d txs archived, %d skipped\n", log, converted, skipped)
+	}
+	return w.Close()
+}
+
+func summarize(path string) error {
+	r, err := archive.Open(path)
+	if err != nil {
+		return err
+	}
+	defer r.Close()
+
+	perType := map[uint8]int{}
+	if err := r.Scan(nil, func(row *archive.Row) bool {
+		perType[row.TxType]++
+		return true
+	}); err != nil {
+		return err
+	}
+	fmt.Printf("%d txs in %d blocks\n", r.Rows(), r.Blocks())
+	for txType, n := range perType {
+		fmt.Printf("  tx type %d: %d\n", txType, n)
+	}
+	if r.Truncated() {
+		fmt.Println("the last block is incomplete and was ignored")
+	}
+	return nil
+}
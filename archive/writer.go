@@ -0,0 +1,243 @@
+package archive
+
+import (
+	"bufio"
+	"encoding/binary"
+	"encoding/hex"
+	"fmt"
+	"io"
+	"os"
+	"sync"
+
+	"github.com/elliottech/lighter-go/types/txtypes"
+)
+
+type WriterConfig struct {
+	// BlockRows is the number of txs per block. Defaults to 65536.
+	BlockRows int
+	// ChainId is used to compute the hash of txs which don't carry it (e.g. parsed from their JSON).
+	// If 0, their hash is stored as zeroes.
+	ChainId uint32
+}
+
+// Writer appends txs to an archive. It's safe for concurrent use, so signing goroutines can append directly.
+type Writer struct {
+	cfg WriterConfig
+
+	mu     sync.Mutex
+	out    *bufio.Writer
+	closer io.Closer
+	err    error
+
+	rows   int
+	ints   [numIntColumns][]int64
+	hashes []byte
+	sigs   []byte
+	block  []byte
+}
+
+// Create creates (or truncates) an archive file
+func Create(path string, cfg WriterConfig) (*Writer, error) {
+	f, err := os.Create(path)
+	if err != nil {
+		return nil, err
+	}
+	w, err := NewWriter(f, cfg)
+	if err != nil {
+		_ = f.Close()
+		return nil, err
+	}
+	w.closer = f
+	return w, nil
+}
+
+// NewWriter writes an archive to out. Close flushes it, and closes out if it was opened by Create.
+func NewWriter(out io.Writer, cfg WriterConfig) (*Writer, error) {
+	if cfg.BlockRows <= 0 {
+		cfg.BlockRows = 1 << 16
+	}
+	w := &Writer{cfg: cfg, out: bufio.NewWriterSize(out, 1<<20)}
+	for i := range w.ints {
+		w.ints[i] = make([]int64, 0, cfg.BlockRows)
+	}
+	w.hashes = make([]byte, 0, cfg.BlockRows*HashSize)
+	w.sigs = make([]byte, 0, cfg.BlockRows*SigSize)
+	if _, err := w.out.Write(fileMagic[:]); err != nil {
+		return nil, err
+	}
+	return w, nil
+}
+
+// Append adds a signed CreateOrder, ModifyOrder, CancelOrder or CancelAllOrders tx.
+// The block is written out once it holds BlockRows txs.
+func (w *Writer) Append(tx txtypes.TxInfo) error {
+	var (
+		values [numIntColumns]int64
+		attrs  txtypes.L2TxAttributes
+		sig    []byte
+	)
+	values[ColTxType] = int64(tx.GetTxType())
+	switch tx := tx.(type) {
+	case *txtypes.L2CreateOrderTxInfo:
+		values[ColAccountIndex], values[ColApiKeyIndex] = tx.AccountIndex, int64(tx.ApiKeyIndex)
+		if tx.OrderInfo != nil {
+			values[ColMarketIndex] = int64(tx.MarketIndex)
+			values[ColIndex] = tx.ClientOrderIndex
+			values[ColBaseAmount] = tx.BaseAmount
+			values[ColPrice] = int64(tx.Price)
+			values[ColIsAsk] = int64(tx.IsAsk)
+			values[ColOrderType] = int64(tx.Type)
+			values[ColTimeInForce] = int64(tx.TimeInForce)
+			values[ColReduceOnly] = int64(tx.ReduceOnly)
+			values[ColTriggerPrice] = int64(tx.TriggerPrice)
+			values[ColOrderExpiry] = tx.OrderExpiry
+		}
+		values[ColExpiredAt], values[ColNonce] = tx.ExpiredAt, tx.Nonce
+		attrs, sig = tx.L2TxAttributes, tx.Sig
+	case *txtypes.L2ModifyOrderTxInfo:
+		values[ColAccountIndex], values[ColApiKeyIndex] = tx.AccountIndex, int64(tx.ApiKeyIndex)
+		values[ColMarketIndex] = int64(tx.MarketIndex)
+		values[ColIndex] = tx.Index
+		values[ColBaseAmount] = tx.BaseAmount
+		values[ColPrice] = int64(tx.Price)
+		values[ColTriggerPrice] = int64(tx.TriggerPrice)
+		values[ColExpiredAt], values[ColNonce] = tx.ExpiredAt, tx.Nonce
+		attrs, sig = tx.L2TxAttributes, tx.Sig
+	case *txtypes.L2CancelOrderTxInfo:
+		values[ColAccountIndex], values[ColApiKeyIndex] = tx.AccountIndex, int64(tx.ApiKeyIndex)
+		values[ColMarketIndex] = int64(tx.MarketIndex)
+		values[ColIndex] = tx.Index
+		values[ColExpiredAt], values[ColNonce] = tx.ExpiredAt, tx.Nonce
+		attrs, sig = tx.L2TxAttributes, tx.Sig
+	case *txtypes.L2CancelAllOrdersTxInfo:
+		values[ColAccountIndex], values[ColApiKeyIndex] = tx.AccountIndex, int64(tx.ApiKeyIndex)
+		values[ColTimeInForce] = int64(tx.TimeInForce)
+		values[ColTime] = tx.Time
+		values[ColExpiredAt], values[ColNonce] = tx.ExpiredAt, tx.Nonce
+		attrs, sig = tx.L2TxAttributes, tx.Sig
+	default:
+		return fmt.Errorf("%w, got %T", ErrUnsupportedTx, tx)
+	}
+	values[ColSkipNonce] = int64(attrs[txtypes.AttributeTypeSkipTxNonce])
+	values[ColIntegratorAccountIndex] = int64(attrs[txtypes.AttributeTypeIntegratorAccountIndex])
+	values[ColIntegratorTakerFee] = int64(attrs[txtypes.AttributeTypeIntegratorTakerFee])
+	values[ColIntegratorMakerFee] = int64(attrs[txtypes.AttributeTypeIntegratorMakerFee])
+
+	if len(sig) != 0 && len(sig) != SigSize {
+		return fmt.Errorf("signature is %d bytes, expected %d", len(sig), SigSize)
+	}
+	var hash [HashSize]byte
+	if txHash := tx.GetTxHash(); txHash != "" {
+		if n, err := hex.Decode(hash[:], []byte(txHash)); err != nil || n != HashSize {
+			return fmt.Errorf("invalid tx hash %q", txHash)
+		}
+	} else if w.cfg.ChainId != 0 {
+		msgHash, err := tx.Hash(w.cfg.ChainId)
+		if err != nil {
+			return err
+		}
+		copy(hash[:], msgHash)
+	}
+
+	w.mu.Lock()
+	defer w.mu.Unlock()
+	if w.err != nil {
+		return w.err
+	}
+	for i := range values {
+		w.ints[i] = append(w.ints[i], values[i])
+	}
+	w.hashes = append(w.hashes, hash[:]...)
+	if len(sig) == 0 {
+		var zero [SigSize]byte
+		sig = zero[:]
+	}
+	w.sigs = append(w.sigs, sig...)
+	w.rows++
+	if w.rows >= w.cfg.BlockRows {
+		w.err = w.writeBlock()
+	}
+	return w.err
+}
+
+// Flush ends the current block, even if it's not full, and writes it out
+func (w *Writer) Flush() error {
+	w.mu.Lock()
+	defer w.mu.Unlock()
+	if w.err != nil {
+		return w.err
+	}
+	if w.rows > 0 {
+		if w.err = w.writeBlock(); w.err != nil {
+			return w.err
+		}
+	}
+	w.err = w.out.Flush()
+	return w.err
+}
+
+func (w *Writer) Close() error {
+	err := w.Flush()
+	if w.closer != nil {
+		if closeErr := w.closer.Close(); err == nil {
+			err = closeErr
+		}
+	}
+	return err
+}
+
+// writeBlock encodes the buffered rows and flushes them, so readers & crashes see whole blocks.
+// Must be called with the lock held.
+func (w *Writer) writeBlock() error {
+	var dir [numColumns][columnEntrySize]byte
+	data := w.block[:0]
+	for c := Column(0); c < numIntColumns; c++ {
+		start := len(data)
+		var (
+			enc        uint8
+			minV, maxV int64
+		)
+		data, enc, minV, maxV = encodeInts(data, w.ints[c])
+		putColumnEntry(dir[c][:], uint8(c), enc, minV, maxV, start, len(data)-start)
+		w.ints[c] = w.ints[c][:0]
+	}
+	fixed := []struct {
+		c    Column
+		data []byte
+	}{{colHash, w.hashes}, {colSig, w.sigs}}
+	for _, col := range fixed {
+		start := len(data)
+		data = append(data, col.data...)
+		putColumnEntry(dir[col.c][:], uint8(col.c), encFixed, 0, 0, start, len(col.data))
+	}
+	w.block = data
+	w.hashes, w.sigs = w.hashes[:0], w.sigs[:0]
+
+	var header [blockHeaderSize]byte
+	binary.LittleEndian.PutUint32(header[0:], blockMagic)
+	binary.LittleEndian.PutUint32(header[4:], uint32(len(dir)*columnEntrySize+len(data)))
+	binary.LittleEndian.PutUint32(header[8:], uint32(w.rows))
+	binary.LittleEndian.PutUint32(header[12:], uint32(numColumns))
+	w.rows = 0
+
+	if _, err := w.out.Write(header[:]); err != nil {
+		return err
+	}
+	for i := range dir {
+		if _, err := w.out.Write(dir[i][:]); err != nil {
+			return err
+		}
+	}
+	if _, err := w.out.Write(data); err != nil {
+		return err
+	}
+	return w.out.Flush()
+}
+
+func putColumnEntry(b []byte, col, enc uint8, minV, maxV int64, offset, length int) {
+	b[0], b[1] = col, enc
+	binary.LittleEndian.PutUint64(b[2:], uint64(minV))
+	binary.LittleEndian.PutUint64(b[10:], uint64(maxV))
+	binary.LittleEndian.PutUint32(b[18:], uint32(offset))
+	binary.LittleEndian.PutUint32(b[22:], uint32(length))
+}
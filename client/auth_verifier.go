@@ -0,0 +1,244 @@
+package client
+
+import (
+	"encoding/hex"
+	"errors"
+	"hash/maphash"
+	"strconv"
+	"strings"
+	"sync"
+	"sync/atomic"
+	"time"
+
+	schnorr "github.com/elliottech/poseidon_crypto/signature/schnorr"
+
+	"github.com/elliottech/lighter-go/types"
+)
+
+var (
+	ErrAuthTokenMalformed        = errors.New("malformed auth token")
+	ErrAuthTokenExpired          = errors.New("auth token expired")
+	ErrAuthTokenNotYetValid      = errors.New("auth token deadline is too far in the future")
+	ErrAuthTokenUnknownKey       = errors.New("auth token signed by an unregistered api key")
+	ErrAuthTokenInvalidSignature = errors.New("invalid auth token signature")
+)
+
+const authVerifierShards = 16
+
+// AuthTokenClaims are the fields of a verified auth token
+type AuthTokenClaims struct {
+	Deadline     time.Time
+	AccountIndex int64
+	ApiKeyIndex  uint8
+}
+
+type AuthVerifierConfig struct {
+	// MaxTokenDuration is the longest a token can be valid for: tokens with a deadline further away are refused
+	// until it gets closer. Defaults to 8 hours, like the server.
+	MaxTokenDuration time.Duration
+	// MaxCachedTokens bounds the number of verified tokens kept. Defaults to 65536, negative disables the cache.
+	MaxCachedTokens int
+}
+
+type AuthVerifierStats struct {
+	Hits     uint64
+	Misses   uint64
+	Failures uint64
+	Cached   int
+}
+
+type authKeyID struct {
+	accountIndex int64
+	apiKeyIndex  uint8
+}
+
+type authKey struct {
+	pubKey [40]byte
+}
+
+type cachedAuthToken struct {
+	claims AuthTokenClaims
+	// key the token was verified with; the entry is stale once the key was replaced or removed
+	key *authKey
+}
+
+type authCacheShard struct {
+	mu     sync.RWMutex
+	tokens map[string]cachedAuthToken
+}
+
+// AuthVerifier checks auth tokens (as built by ConstructAuthToken) against the public keys registered with RegisterKey.
+// Verified tokens are cached until their deadline, so a token seen again costs a map lookup instead of a
+// Poseidon2 hash and a Schnorr verification. Replacing or removing a key invalidates the tokens it signed.
+type AuthVerifier struct {
+	cfg      AuthVerifierConfig
+	perShard int
+
+	keysMu sync.RWMutex
+	keys   map[authKeyID]*authKey
+
+	seed   maphash.Seed
+	shards [authVerifierShards]authCacheShard
+
+	hits     atomic.Uint64
+	misses   atomic.Uint64
+	failures atomic.Uint64
+}
+
+func NewAuthVerifier(cfg AuthVerifierConfig) *AuthVerifier {
+	if cfg.MaxTokenDuration <= 0 {
+		cfg.MaxTokenDuration = 8 * time.Hour
+	}
+	if cfg.MaxCachedTokens == 0 {
+		cfg.MaxCachedTokens = 1 << 16
+	}
+	v := &AuthVerifier{
+		cfg:      cfg,
+		perShard: max(cfg.MaxCachedTokens/authVerifierShards, 1),
+		keys:     make(map[authKeyID]*authKey),
+		seed:     maphash.MakeSeed(),
+	}
+	for i := range v.shards {
+		v.shards[i].tokens = make(map[string]cachedAuthToken)
+	}
+	return v
+}
+
+// RegisterKey sets the public key of an (account, apiKey) pair, as returned by the apikeys endpoint or PubKeyBytes.
+func (v *AuthVerifier) RegisterKey(accountIndex int64, apiKeyIndex uint8, pubKey [40]byte) {
+	v.keysMu.Lock()
+	defer v.keysMu.Unlock()
+	v.keys[authKeyID{accountIndex, apiKeyIndex}] = &authKey{pubKey: pubKey}
+}
+
+func (v *AuthVerifier) RemoveKey(accountIndex int64, apiKeyIndex uint8) {
+	v.keysMu.Lock()
+	defer v.keysMu.Unlock()
+	delete(v.keys, authKeyID{accountIndex, apiKeyIndex})
+}
+
+func (v *AuthVerifier) key(accountIndex int64, apiKeyIndex uint8) *authKey {
+	v.keysMu.RLock()
+	defer v.keysMu.RUnlock()
+	return v.keys[authKeyID{accountIndex, apiKeyIndex}]
+}
+
+func (v *AuthVerifier) Stats() AuthVerifierStats {
+	s := AuthVerifierStats{Hits: v.hits.Load(), Misses: v.misses.Load(), Failures: v.failures.Load()}
+	for i := range v.shards {
+		shard := &v.shards[i]
+		shard.mu.RLock()
+		s.Cached += len(shard.tokens)
+		shard.mu.RUnlock()
+	}
+	return s
+}
+
+// Verify checks a `deadline:account:apiKey:signature` token and returns its claims.
+func (v *AuthVerifier) Verify(token string) (AuthTokenClaims, error) {
+	return v.VerifyAt(token, time.Now())
+}
+
+// VerifyAt is Verify at a given time
+func (v *AuthVerifier) VerifyAt(token string, now time.Time) (AuthTokenClaims, error) {
+	var shard *authCacheShard
+	if v.cfg.MaxCachedTokens > 0 {
+		shard = &v.shards[maphash.String(v.seed, token)%authVerifierShards]
+		shard.mu.RLock()
+		cached, ok := shard.tokens[token]
+		shard.mu.RUnlock()
+		if ok {
+			if now.Before(cached.claims.Deadline) && v.key(cached.claims.AccountIndex, cached.claims.ApiKeyIndex) == cached.key {
+				v.hits.Add(1)
+				return cached.claims, nil
+			}
+			shard.mu.Lock()
+			delete(shard.tokens, token)
+			shard.mu.Unlock()
+		}
+	}
+	v.misses.Add(1)
+
+	claims, key, err := v.verify(token, now)
+	if err != nil {
+		v.failures.Add(1)
+		return AuthTokenClaims{}, err
+	}
+	if shard != nil {
+		shard.mu.Lock()
+		if len(shard.tokens) >= v.perShard {
+			shard.evict(now)
+		}
+		shard.tokens[token] = cachedAuthToken{claims: claims, key: key}
+		shard.mu.Unlock()
+	}
+	return claims, nil
+}
+
+// evict drops the expired tokens, or half of the shard if none expired. Must be called with the lock held.
+func (s *authCacheShard) evict(now time.Time) {
+	before := len(s.tokens)
+	for token, cached := range s.tokens {
+		if !now.Before(cached.claims.Deadline) {
+			delete(s.tokens, token)
+		}
+	}
+	if len(s.tokens) < before {
+		return
+	}
+	n := before / 2
+	for token := range s.tokens {
+		if n == 0 {
+			break
+		}
+		delete(s.tokens, token)
+		n--
+	}
+}
+
+func (v *AuthVerifier) verify(token string, now time.Time) (AuthTokenClaims, *authKey, error) {
+	sep := strings.LastIndexByte(token, ':')
+	if sep < 0 {
+		return AuthTokenClaims{}, nil, ErrAuthTokenMalformed
+	}
+	message, sigHex := token[:sep], token[sep+1:]
+	parts := strings.Split(message, ":")
+	if len(parts) != 3 {
+		return AuthTokenClaims{}, nil, ErrAuthTokenMalformed
+	}
+	deadline, err1 := strconv.ParseInt(parts[0], 10, 64)
+	accountIndex, err2 := strconv.ParseInt(parts[1], 10, 64)
+	apiKeyIndex, err3 := strconv.ParseUint(parts[2], 10, 8)
+	if err1 != nil || err2 != nil || err3 != nil {
+		return AuthTokenClaims{}, nil, ErrAuthTokenMalformed
+	}
+	claims := AuthTokenClaims{
+		Deadline:     time.Unix(deadline, 0),
+		AccountIndex: accountIndex,
+		ApiKeyIndex:  uint8(apiKeyIndex),
+	}
+
+	if !now.Before(claims.Deadline) {
+		return AuthTokenClaims{}, nil, ErrAuthTokenExpired
+	}
+	if claims.Deadline.Sub(now) > v.cfg.MaxTokenDuration {
+		return AuthTokenClaims{}, nil, ErrAuthTokenNotYetValid
+	}
+	key := v.key(claims.AccountIndex, claims.ApiKeyIndex)
+	if key == nil {
+		return AuthTokenClaims{}, nil, ErrAuthTokenUnknownKey
+	}
+
+	sig, err := hex.DecodeString(sigHex)
+	if err != nil {
+		return AuthTokenClaims{}, nil, ErrAuthTokenMalformed
+	}
+	msgHash, err := types.HashAuthTokenMessage(message)
+	if err != nil {
+		return AuthTokenClaims{}, nil, ErrAuthTokenMalformed
+	}
+	if err := schnorr.Validate(key.pubKey[:], msgHash, sig); err != nil {
+		return AuthTokenClaims{}, nil, ErrAuthTokenInvalidSignature
+	}
+	return claims, key, nil
+}
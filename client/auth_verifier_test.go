@@ -0,0 +1,99 @@
+package client
+
+import (
+	"errors"
+	"fmt"
+	"testing"
+	"time"
+)
+
+func newAuthVerifierTestToken(tb testing.TB, c *TxClient, v *AuthVerifier, deadline time.Time) string {
+	tb.Helper()
+	v.RegisterKey(c.GetAccountIndex(), c.GetApiKeyIndex(), c.GetKeyManager().PubKeyBytes())
+	token, err := c.GetAuthToken(deadline)
+	if err != nil {
+		tb.Fatal(err)
+	}
+	return token
+}
+
+func TestAuthVerifier(t *testing.T) {
+	clients := newPipelineTestClients(t, 2)
+	v := NewAuthVerifier(AuthVerifierConfig{})
+	now := time.Now()
+	token := newAuthVerifierTestToken(t, clients[0], v, now.Add(time.Hour))
+
+	for i := 0; i < 2; i++ {
+		claims, err := v.VerifyAt(token, now)
+		if err != nil {
+			t.Fatal(err)
+		}
+		if claims.AccountIndex != clients[0].GetAccountIndex() || claims.ApiKeyIndex != clients[0].GetApiKeyIndex() || claims.Deadline.Unix() != now.Add(time.Hour).Unix() {
+			t.Errorf("claims = %+v", claims)
+		}
+	}
+	if s := v.Stats(); s.Hits != 1 || s.Misses != 1 || s.Cached != 1 {
+		t.Errorf("stats = %+v", s)
+	}
+
+	if _, err := v.VerifyAt(token, now.Add(2*time.Hour)); !errors.Is(err, ErrAuthTokenExpired) {
+		t.Errorf("err = %v, want ErrAuthTokenExpired", err)
+	}
+	far := newAuthVerifierTestToken(t, clients[0], v, now.Add(20*time.Hour))
+	if _, err := v.VerifyAt(far, now); !errors.Is(err, ErrAuthTokenNotYetValid) {
+		t.Errorf("err = %v, want ErrAuthTokenNotYetValid", err)
+	}
+	tampered := []byte(token)
+	if tampered[len(tampered)-1] == '0' {
+		tampered[len(tampered)-1] = '1'
+	} else {
+		tampered[len(tampered)-1] = '0'
+	}
+	if _, err := v.VerifyAt(string(tampered), now); !errors.Is(err, ErrAuthTokenInvalidSignature) {
+		t.Errorf("err = %v, want ErrAuthTokenInvalidSignature", err)
+	}
+	if _, err := v.VerifyAt("1:2:3", now); !errors.Is(err, ErrAuthTokenMalformed) {
+		t.Errorf("err = %v, want ErrAuthTokenMalformed", err)
+	}
+
+	// replacing the key invalidates the cached token
+	v.RegisterKey(clients[0].GetAccountIndex(), clients[0].GetApiKeyIndex(), clients[1].GetKeyManager().PubKeyBytes())
+	if _, err := v.VerifyAt(token, now); !errors.Is(err, ErrAuthTokenInvalidSignature) {
+		t.Errorf("err = %v, want ErrAuthTokenInvalidSignature", err)
+	}
+	v.RemoveKey(clients[0].GetAccountIndex(), clients[0].GetApiKeyIndex())
+	if _, err := v.VerifyAt(token, now); !errors.Is(err, ErrAuthTokenUnknownKey) {
+		t.Errorf("err = %v, want ErrAuthTokenUnknownKey", err)
+	}
+}
+
+// BenchmarkAuthVerify verifies a rotating set of tokens, from several goroutines
+func BenchmarkAuthVerify(b *testing.B) {
+	for _, cached := range []bool{false, true} {
+		b.Run(fmt.Sprintf("cached=%v", cached), func(b *testing.B) {
+			cfg := AuthVerifierConfig{}
+			if !cached {
+				cfg.MaxCachedTokens = -1
+			}
+			v := NewAuthVerifier(cfg)
+			c := newPipelineTestClients(b, 1)[0]
+			tokens := make([]string, 1024)
+			for i := range tokens {
+				tokens[i] = newAuthVerifierTestToken(b, c, v, time.Now().Add(time.Hour+time.Duration(i)*time.Second))
+			}
+
+			b.ReportAllocs()
+			b.ResetTimer()
+			b.RunParallel(func(pb *testing.PB) {
+				i := 0
+				for pb.Next() {
+					if _, err := v.Verify(tokens[i%len(tokens)]); err != nil {
+						b.Error(err)
+						return
+					}
+					i++
+				}
+			})
+		})
+	}
+}
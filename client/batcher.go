@@ -0,0 +1,325 @@
+package client
+
+import (
+	"encoding/json"
+	"fmt"
+	"sync"
+	"sync/atomic"
+	"time"
+)
+
+type BatcherConfig struct {
+	// MaxBatch is the largest number of transactions sent in one request. Defaults to 50.
+	MaxBatch int
+	// MaxDelay bounds how long a transaction waits for others to join its batch. Defaults to 1ms.
+	MaxDelay time.Duration
+	// MaxInFlight is the number of requests sent concurrently. Defaults to 4.
+	// While all of them are in flight, new transactions keep accumulating into the next batch.
+	// A request waits for the earlier ones holding transactions of the same (account, apiKey) pair,
+	// so the transactions of a pair arrive in submission order, which is their nonce order.
+	MaxInFlight int
+}
+
+type BatcherStats struct {
+	// Requests sent (single transactions & batches) and transactions sent through them
+	Requests uint64
+	Txs      uint64
+	// Failed counts the transactions of requests which returned an error
+	Failed uint64
+	// Window is the current batching delay, 0 when idle
+	Window time.Duration
+}
+
+type batchItem struct {
+	txType uint8
+	txInfo string
+	done   func(txHash string, err error)
+	// the (account, apiKey) pair of the tx, unless its JSON didn't have one
+	key   clientKey
+	keyed bool
+}
+
+// batchTxKey reads the (account, apiKey) pair which signed txInfo
+func batchTxKey(txInfo string) (clientKey, bool) {
+	var tx struct {
+		AccountIndex     *int64
+		FromAccountIndex *int64
+		ApiKeyIndex      *uint8
+	}
+	if err := json.Unmarshal([]byte(txInfo), &tx); err != nil || tx.ApiKeyIndex == nil {
+		return clientKey{}, false
+	}
+	switch {
+	case tx.AccountIndex != nil:
+		return clientKey{accountIndex: *tx.AccountIndex, apiKeyIndex: *tx.ApiKeyIndex}, true
+	case tx.FromAccountIndex != nil:
+		return clientKey{accountIndex: *tx.FromAccountIndex, apiKeyIndex: *tx.ApiKeyIndex}, true
+	}
+	return clientKey{}, false
+}
+
+// TxBatcher collects signed transactions and sends them with as few requests as possible, without delaying them when idle.
+//
+// Transactions which arrive while all MaxInFlight requests are pending join the next batch at no extra delay.
+// On top of that, the batching window (how long a batch waits for more transactions) grows up to MaxDelay while
+// batches keep forming, and drops back to 0 as soon as a batch ends up with a single transaction,
+// so a lone transaction is sent right away with SendTx.
+// Requests holding transactions of the same (account, apiKey) pair are sent one at a time, in order.
+type TxBatcher struct {
+	sender TxSender
+	cfg    BatcherConfig
+
+	closeMu sync.RWMutex
+	closed  bool
+	items   chan batchItem
+	slots   chan struct{}
+	flushes sync.WaitGroup
+	done    chan struct{}
+
+	// requests in flight per (account, apiKey) pair
+	keysMu   sync.Mutex
+	keysFree *sync.Cond
+	inFlight map[clientKey]int
+
+	requests atomic.Uint64
+	txs      atomic.Uint64
+	failed   atomic.Uint64
+	window   atomic.Int64
+}
+
+func NewTxBatcher(sender TxSender, cfg BatcherConfig) *TxBatcher {
+	if cfg.MaxBatch <= 0 {
+		cfg.MaxBatch = 50
+	}
+	if cfg.MaxDelay <= 0 {
+		cfg.MaxDelay = time.Millisecond
+	}
+	if cfg.MaxInFlight <= 0 {
+		cfg.MaxInFlight = 4
+	}
+
+	b := &TxBatcher{
+		sender:   sender,
+		cfg:      cfg,
+		items:    make(chan batchItem, cfg.MaxBatch*cfg.MaxInFlight),
+		slots:    make(chan struct{}, cfg.MaxInFlight),
+		done:     make(chan struct{}),
+		inFlight: make(map[clientKey]int),
+	}
+	b.keysFree = sync.NewCond(&b.keysMu)
+	go b.run()
+	return b
+}
+
+// Submit queues a signed transaction. done is called from another goroutine once the request containing it returned.
+func (b *TxBatcher) Submit(txType uint8, txInfo string, done func(txHash string, err error)) error {
+	b.closeMu.RLock()
+	defer b.closeMu.RUnlock()
+	if b.closed {
+		return fmt.Errorf("batcher is closed")
+	}
+	key, keyed := batchTxKey(txInfo)
+	b.items <- batchItem{txType: txType, txInfo: txInfo, done: done, key: key, keyed: keyed}
+	return nil
+}
+
+// Send queues a signed transaction and waits for the request containing it.
+func (b *TxBatcher) Send(txType uint8, txInfo string) (string, error) {
+	type result struct {
+		txHash string
+		err    error
+	}
+	ch := make(chan result, 1)
+	if err := b.Submit(txType, txInfo, func(txHash string, err error) { ch <- result{txHash, err} }); err != nil {
+		return "", err
+	}
+	res := <-ch
+	return res.txHash, res.err
+}
+
+// Close sends the pending transactions and waits for all requests to return.
+func (b *TxBatcher) Close() {
+	b.closeMu.Lock()
+	if !b.closed {
+		b.closed = true
+		close(b.items)
+	}
+	b.closeMu.Unlock()
+	<-b.done
+}
+
+func (b *TxBatcher) Stats() BatcherStats {
+	return BatcherStats{
+		Requests: b.requests.Load(),
+		Txs:      b.txs.Load(),
+		Failed:   b.failed.Load(),
+		Window:   time.Duration(b.window.Load()),
+	}
+}
+
+// adapt sets the window of the next batch from the size of the last one: no delay if waiting didn't gather
+// anything (idle, or a single sender waiting on each response), longer while batches form but don't fill up,
+// and shorter once they fill up before the window ends.
+func (b *TxBatcher) adapt(window time.Duration, size int) time.Duration {
+	switch {
+	case size <= 1:
+		return 0
+	case size >= b.cfg.MaxBatch:
+		return window / 2
+	case window == 0:
+		return b.cfg.MaxDelay / 16
+	default:
+		return min(window*2, b.cfg.MaxDelay)
+	}
+}
+
+func (b *TxBatcher) run() {
+	defer close(b.done)
+	defer b.flushes.Wait()
+
+	timer := time.NewTimer(time.Hour)
+	timer.Stop()
+
+	var window time.Duration
+	for {
+		first, ok := <-b.items
+		if !ok {
+			return
+		}
+		batch := []batchItem{first}
+
+		expired := false
+		if window > 0 {
+			timer.Reset(window)
+		}
+	collect:
+		for len(batch) < b.cfg.MaxBatch {
+			var (
+				item batchItem
+				ok   bool
+			)
+			if window == 0 {
+				select {
+				case item, ok = <-b.items:
+				default:
+					break collect
+				}
+			} else {
+				select {
+				case item, ok = <-b.items:
+				case <-timer.C:
+					expired = true
+					break collect
+				}
+			}
+			if !ok {
+				break collect
+			}
+			batch = append(batch, item)
+		}
+		if window > 0 && !expired && !timer.Stop() {
+			select {
+			case <-timer.C:
+			default:
+			}
+		}
+
+		// while every request is in flight, whatever arrives meanwhile joins this batch
+		b.slots <- struct{}{}
+	topUp:
+		for len(batch) < b.cfg.MaxBatch {
+			select {
+			case item, ok := <-b.items:
+				if !ok {
+					break topUp
+				}
+				batch = append(batch, item)
+			default:
+				break topUp
+			}
+		}
+
+		window = b.adapt(window, len(batch))
+		b.window.Store(int64(window))
+
+		b.reserveKeys(batch)
+		b.flushes.Add(1)
+		go b.flush(batch)
+	}
+}
+
+// reserveKeys waits until no request in flight holds a tx of the pairs of batch, then marks them in flight
+func (b *TxBatcher) reserveKeys(batch []batchItem) {
+	b.keysMu.Lock()
+	defer b.keysMu.Unlock()
+wait:
+	for {
+		for _, item := range batch {
+			if item.keyed && b.inFlight[item.key] > 0 {
+				b.keysFree.Wait()
+				continue wait
+			}
+		}
+		break
+	}
+	for _, item := range batch {
+		if item.keyed {
+			b.inFlight[item.key]++
+		}
+	}
+}
+
+func (b *TxBatcher) releaseKeys(batch []batchItem) {
+	b.keysMu.Lock()
+	defer b.keysMu.Unlock()
+	for _, item := range batch {
+		if !item.keyed {
+			continue
+		}
+		if b.inFlight[item.key]--; b.inFlight[item.key] == 0 {
+			delete(b.inFlight, item.key)
+		}
+	}
+	b.keysFree.Broadcast()
+}
+
+func (b *TxBatcher) flush(batch []batchItem) {
+	defer func() {
+		b.releaseKeys(batch)
+		<-b.slots
+		b.flushes.Done()
+	}()
+
+	var (
+		txHashes []string
+		err      error
+	)
+	if len(batch) == 1 {
+		var txHash string
+		txHash, err = b.sender.SendTx(batch[0].txType, batch[0].txInfo)
+		txHashes = []string{txHash}
+	} else {
+		txTypes := make([]uint8, len(batch))
+		txInfos := make([]string, len(batch))
+		for i, item := range batch {
+			txTypes[i], txInfos[i] = item.txType, item.txInfo
+		}
+		txHashes, err = b.sender.SendTxBatch(txTypes, txInfos)
+	}
+
+	b.requests.Add(1)
+	b.txs.Add(uint64(len(batch)))
+	if err != nil {
+		b.failed.Add(uint64(len(batch)))
+	}
+	for i, item := range batch {
+		if item.done == nil {
+			continue
+		}
+		if err != nil {
+			item.done("", err)
+		} else {
+			item.done(txHashes[i], nil)
+		}
+	}
+}
@@ -0,0 +1,164 @@
+package client
+
+import (
+	"encoding/json"
+	"fmt"
+	"math/rand"
+	"sync"
+	"testing"
+	"time"
+)
+
+// fakeTxSender answers with "hash-<txInfo>" after a fixed latency
+type fakeTxSender struct {
+	latency time.Duration
+
+	mu      sync.Mutex
+	batches []int
+}
+
+func (s *fakeTxSender) SendTx(txType uint8, txInfo string) (string, error) {
+	hashes, err := s.SendTxBatch([]uint8{txType}, []string{txInfo})
+	if err != nil {
+		return "", err
+	}
+	return hashes[0], nil
+}
+
+func (s *fakeTxSender) SendTxBatch(txTypes []uint8, txInfos []string) ([]string, error) {
+	time.Sleep(s.latency)
+	s.mu.Lock()
+	s.batches = append(s.batches, len(txInfos))
+	s.mu.Unlock()
+
+	hashes := make([]string, len(txInfos))
+	for i, info := range txInfos {
+		hashes[i] = "hash-" + info
+	}
+	return hashes, nil
+}
+
+func TestTxBatcherIdleIsNotDelayed(t *testing.T) {
+	sender := &fakeTxSender{}
+	b := NewTxBatcher(sender, BatcherConfig{MaxDelay: 20 * time.Millisecond})
+	defer b.Close()
+
+	for i := 0; i < 3; i++ {
+		start := time.Now()
+		hash, err := b.Send(14, fmt.Sprint(i))
+		if err != nil {
+			t.Fatal(err)
+		}
+		if hash != fmt.Sprintf("hash-%d", i) {
+			t.Errorf("hash = %s", hash)
+		}
+		if elapsed := time.Since(start); elapsed >= 20*time.Millisecond {
+			t.Errorf("idle transaction waited %v", elapsed)
+		}
+	}
+	if s := b.Stats(); s.Requests != 3 || s.Txs != 3 || s.Window != 0 {
+		t.Errorf("stats = %+v", s)
+	}
+}
+
+func TestTxBatcherBurst(t *testing.T) {
+	sender := &fakeTxSender{latency: 2 * time.Millisecond}
+	b := NewTxBatcher(sender, BatcherConfig{MaxBatch: 16, MaxDelay: time.Millisecond, MaxInFlight: 1})
+
+	const n = 200
+	var wg sync.WaitGroup
+	for i := 0; i < n; i++ {
+		wg.Add(1)
+		go func(i int) {
+			defer wg.Done()
+			hash, err := b.Send(15, fmt.Sprint(i))
+			if err != nil || hash != fmt.Sprintf("hash-%d", i) {
+				t.Errorf("tx %d: %s, %v", i, hash, err)
+			}
+		}(i)
+	}
+	wg.Wait()
+	b.Close()
+
+	s := b.Stats()
+	if s.Txs != n || s.Failed != 0 {
+		t.Errorf("stats = %+v", s)
+	}
+	if s.Requests >= n/4 {
+		t.Errorf("%d requests for %d transactions, expected batching", s.Requests, n)
+	}
+	for _, size := range sender.batches {
+		if size > 16 {
+			t.Errorf("batch of %d exceeds MaxBatch", size)
+		}
+	}
+	if _, err := b.Send(15, "late"); err == nil {
+		t.Error("Send after Close should fail")
+	}
+}
+
+// arrivalTxSender answers after a random latency, and records the txs in the order their request arrived
+type arrivalTxSender struct {
+	mu      sync.Mutex
+	arrived []string
+}
+
+func (s *arrivalTxSender) SendTx(txType uint8, txInfo string) (string, error) {
+	hashes, err := s.SendTxBatch([]uint8{txType}, []string{txInfo})
+	if err != nil {
+		return "", err
+	}
+	return hashes[0], nil
+}
+
+func (s *arrivalTxSender) SendTxBatch(txTypes []uint8, txInfos []string) ([]string, error) {
+	time.Sleep(time.Duration(rand.Intn(2000)) * time.Microsecond)
+	s.mu.Lock()
+	s.arrived = append(s.arrived, txInfos...)
+	s.mu.Unlock()
+	return make([]string, len(txInfos)), nil
+}
+
+func TestTxBatcherKeyOrder(t *testing.T) {
+	c := newPipelineTestClients(t, 1)[0]
+	tx, err := c.GetCreateOrderTransaction(pipelineTestOrder(0), pipelineTestOps(5, 0))
+	if err != nil {
+		t.Fatal(err)
+	}
+	txInfo, err := tx.GetTxInfo()
+	if err != nil {
+		t.Fatal(err)
+	}
+	if key, ok := batchTxKey(txInfo); !ok || key != (clientKey{accountIndex: c.accountIndex, apiKeyIndex: c.apiKeyIndex}) {
+		t.Errorf("key of a signed tx = %+v, %v", key, ok)
+	}
+
+	const keys, perKey = 3, 100
+	sender := &arrivalTxSender{}
+	b := NewTxBatcher(sender, BatcherConfig{MaxBatch: 4, MaxDelay: 100 * time.Microsecond, MaxInFlight: 4})
+	for i := 0; i < keys*perKey; i++ {
+		info := fmt.Sprintf(`{"AccountIndex":1,"ApiKeyIndex":%d,"Nonce":%d}`, i%keys, i/keys)
+		if err := b.Submit(14, info, nil); err != nil {
+			t.Fatal(err)
+		}
+	}
+	b.Close()
+
+	next := make(map[uint8]int64)
+	for _, info := range sender.arrived {
+		var tx struct {
+			ApiKeyIndex uint8
+			Nonce       int64
+		}
+		if err := json.Unmarshal([]byte(info), &tx); err != nil {
+			t.Fatal(err)
+		}
+		if tx.Nonce != next[tx.ApiKeyIndex] {
+			t.Fatalf("key %d: nonce %d arrived, want %d", tx.ApiKeyIndex, tx.Nonce, next[tx.ApiKeyIndex])
+		}
+		next[tx.ApiKeyIndex]++
+	}
+	if len(sender.arrived) != keys*perKey {
+		t.Errorf("%d txs arrived, want %d", len(sender.arrived), keys*perKey)
+	}
+}
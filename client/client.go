@@ -4,6 +4,7 @@ import (
 	"fmt"
 	"strings"
 	"sync"
+	"sync/atomic"
 
 	curve "github.com/elliottech/poseidon_crypto/curve/ecgfp5"
 	schnorr "github.com/elliottech/poseidon_crypto/signature/schnorr"
@@ -13,12 +14,41 @@ import (
 // SharedClientManager holds the global txClient and backupTxClients
 // This will be managed by both sharedlib and wasm builds
 // Supports multiple accounts and API keys with thread safety
-var (
-	txClientMu              sync.Mutex
-	defaultTxClient         *TxClient
-	defaultClientPerAccount = make(map[int64]*TxClient)
-	allTxClients            map[int64]map[uint8]*TxClient // accountIndex -> apiKeyIndex -> client
-)
+var registry = newClientRegistry()
+
+type clientKey struct {
+	accountIndex int64
+	apiKeyIndex  uint8
+}
+
+// clientSlot holds the current client for one (account, apiKey) pair.
+// Replacing the key publishes a new client with a single atomic store; signers which already
+// loaded the previous client finish with it, and lookups never wait on the replacement.
+type clientSlot struct {
+	client atomic.Pointer[TxClient]
+	// rate limits belong to the (account, apiKey) pair, not to the key
+	limits *rateLimits
+}
+
+// clientRegistry stores clients in a slab, indexed by a dense id assigned on first registration.
+// A single map resolves (account, apiKey) to the id, so lookups cost one hash of a small key
+// and the registry stays compact with 100k+ clients.
+// The write lock is only taken to register new pairs or move the defaults, not to replace a key.
+type clientRegistry struct {
+	mu                sync.RWMutex
+	slots             []*clientSlot
+	ids               map[clientKey]uint32
+	defaultPerAccount map[int64]uint32
+	defaultId         int64 // -1 if no client was created
+}
+
+func newClientRegistry() *clientRegistry {
+	return &clientRegistry{
+		ids:               make(map[clientKey]uint32),
+		defaultPerAccount: make(map[int64]uint32),
+		defaultId:         -1,
+	}
+}
 
 // GenerateAPIKey generates a new API key pair from a seed
 func GenerateAPIKey() (string, string, error) {
@@ -32,63 +62,117 @@ func GenerateAPIKey() (string, string, error) {
 // GetClient retrieves a client for specific account and API key
 // If apiKeyIndex==255 && accountIndex==-1, returns default client
 func GetClient(apiKeyIndex uint8, accountIndex int64) (*TxClient, error) {
-	txClientMu.Lock()
-	defer txClientMu.Unlock()
+	return registry.get(apiKeyIndex, accountIndex)
+}
+
+// CreateClient creates a new TxClient and stores it
+// httpClientFactory is a function that creates an HTTP client from a URL string
+func CreateClient(httpClient MinimalHTTPClient, privateKey string, chainId uint32, apiKeyIndex uint8, accountIndex int64) (*TxClient, error) {
+	if accountIndex <= 0 {
+		return nil, fmt.Errorf("invalid account index")
+	}
+
+	txClientInstance, err := NewTxClient(httpClient, privateKey, accountIndex, apiKeyIndex, chainId)
+	if err != nil {
+		return nil, fmt.Errorf("error occurred when creating TxClient. err: %v", err)
+	}
+
+	registry.put(txClientInstance)
+	return txClientInstance, nil
+}
+
+// RotateClient replaces the API key of an already registered (account, apiKey) pair, without changing the defaults.
+// The new client is built before it's published with one atomic swap, so concurrent GetClient calls never block
+// and signatures in progress finish with the old key.
+// onRetire, if not nil, is called with the old client once the new one is visible, e.g. to drop state cached for the old key.
+func RotateClient(httpClient MinimalHTTPClient, privateKey string, chainId uint32, apiKeyIndex uint8, accountIndex int64, onRetire func(old *TxClient)) (*TxClient, error) {
+	txClientInstance, err := NewTxClient(httpClient, privateKey, accountIndex, apiKeyIndex, chainId)
+	if err != nil {
+		return nil, fmt.Errorf("error occurred when creating TxClient. err: %v", err)
+	}
+
+	old, err := registry.swap(txClientInstance)
+	if err != nil {
+		return nil, err
+	}
+	if onRetire != nil {
+		onRetire(old)
+	}
+	return txClientInstance, nil
+}
+
+func (r *clientRegistry) get(apiKeyIndex uint8, accountIndex int64) (*TxClient, error) {
+	r.mu.RLock()
+	defer r.mu.RUnlock()
 
 	if apiKeyIndex == 255 && accountIndex != -1 {
-		client := defaultClientPerAccount[accountIndex]
-		if client != nil {
-			return client, nil
+		if id, ok := r.defaultPerAccount[accountIndex]; ok {
+			return r.slots[id].client.Load(), nil
 		}
 	}
 
 	// Special case: return default client
 	if apiKeyIndex == 255 && accountIndex == -1 {
-		if defaultTxClient == nil {
+		if r.defaultId == -1 {
 			return nil, fmt.Errorf("client is not created, call CreateClient() first")
 		}
-		return defaultTxClient, nil
+		return r.slots[r.defaultId].client.Load(), nil
 	}
 
-	// Look up client in double map
-	var c *TxClient
-	if allTxClients[accountIndex] != nil {
-		c = allTxClients[accountIndex][apiKeyIndex]
-	}
-
-	if c == nil {
+	id, ok := r.ids[clientKey{accountIndex: accountIndex, apiKeyIndex: apiKeyIndex}]
+	if !ok {
 		return nil, fmt.Errorf("client is not created for apiKeyIndex: %v accountIndex: %v", apiKeyIndex, accountIndex)
 	}
-	return c, nil
+	return r.slots[id].client.Load(), nil
 }
 
-// CreateClient creates a new TxClient and stores it
-// httpClientFactory is a function that creates an HTTP client from a URL string
-func CreateClient(httpClient MinimalHTTPClient, privateKey string, chainId uint32, apiKeyIndex uint8, accountIndex int64) (*TxClient, error) {
-	if accountIndex <= 0 {
-		return nil, fmt.Errorf("invalid account index")
+// put registers c, replacing the client previously registered for the same (account, apiKey) pair, if any.
+// c takes over the rate limits of the pair, so it must not be in use yet.
+func (r *clientRegistry) put(c *TxClient) uint32 {
+	key := clientKey{accountIndex: c.accountIndex, apiKeyIndex: c.apiKeyIndex}
+
+	r.mu.Lock()
+	defer r.mu.Unlock()
+
+	id, ok := r.ids[key]
+	if ok {
+		c.limits = r.slots[id].limits
+		r.slots[id].client.Store(c)
+	} else {
+		id = uint32(len(r.slots))
+		slot := &clientSlot{limits: c.limits}
+		slot.client.Store(c)
+		r.slots = append(r.slots, slot)
+		r.ids[key] = id
 	}
 
-	txClientInstance, err := NewTxClient(httpClient, privateKey, accountIndex, apiKeyIndex, chainId)
-	if err != nil {
-		return nil, fmt.Errorf("error occurred when creating TxClient. err: %v", err)
-	}
+	// Update default client (most recently created becomes default)
+	r.defaultId = int64(id)
+	r.defaultPerAccount[c.accountIndex] = id
+	return id
+}
 
-	txClientMu.Lock()
-	if allTxClients == nil {
-		allTxClients = make(map[int64]map[uint8]*TxClient)
-	}
-	if allTxClients[accountIndex] == nil {
-		allTxClients[accountIndex] = make(map[uint8]*TxClient)
+// swap publishes c in place of the client registered for the same (account, apiKey) pair and returns the old one.
+// Only the read lock is held, so lookups proceed concurrently. c takes over the rate limits of the pair,
+// so it must not be in use yet.
+func (r *clientRegistry) swap(c *TxClient) (*TxClient, error) {
+	r.mu.RLock()
+	defer r.mu.RUnlock()
+
+	id, ok := r.ids[clientKey{accountIndex: c.accountIndex, apiKeyIndex: c.apiKeyIndex}]
+	if !ok {
+		return nil, fmt.Errorf("client is not created for apiKeyIndex: %v accountIndex: %v", c.apiKeyIndex, c.accountIndex)
 	}
-	allTxClients[accountIndex][apiKeyIndex] = txClientInstance
 
-	// Update default client (most recently created becomes default)
-	defaultTxClient = txClientInstance
-	defaultClientPerAccount[accountIndex] = txClientInstance
-	txClientMu.Unlock()
+	slot := r.slots[id]
+	c.limits = slot.limits
+	return slot.client.Swap(c), nil
+}
 
-	return txClientInstance, nil
+func (r *clientRegistry) len() int {
+	r.mu.RLock()
+	defer r.mu.RUnlock()
+	return len(r.slots)
 }
 
 // Check validates that the client exists and the API key matches the one on the server
@@ -0,0 +1,216 @@
+package client
+
+import (
+	"fmt"
+	"math/bits"
+	"runtime"
+	"sync"
+	"sync/atomic"
+	"testing"
+	"time"
+)
+
+// newRegistryTestClient returns a fresh client for (testAccountIndex, apiKeyIndex)
+func newRegistryTestClient(tb testing.TB, apiKeyIndex uint8) *TxClient {
+	tb.Helper()
+	priv, _, err := GenerateAPIKey()
+	if err != nil {
+		tb.Fatalf("GenerateAPIKey error: %v", err)
+	}
+	c, err := NewTxClient(nil, priv, testAccountIndex, apiKeyIndex, testChainID)
+	if err != nil {
+		tb.Fatalf("NewTxClient failed: %v", err)
+	}
+	return c
+}
+
+func TestClientRegistryReplace(t *testing.T) {
+	clients := newPipelineTestClients(t, 2)
+	r := newClientRegistry()
+
+	if _, err := r.get(255, -1); err == nil {
+		t.Error("expected an error when no default client exists")
+	}
+
+	id0 := r.put(clients[0])
+	id1 := r.put(clients[1])
+	if id0 == id1 {
+		t.Fatalf("distinct keys got the same id %d", id0)
+	}
+
+	// re-registering the same (account, apiKey) reuses the slot
+	replacement := newRegistryTestClient(t, clients[0].apiKeyIndex)
+	if id := r.put(replacement); id != id0 {
+		t.Errorf("replacement id = %d, want %d", id, id0)
+	}
+	if r.len() != 2 {
+		t.Errorf("len = %d, want 2", r.len())
+	}
+
+	c, err := r.get(testAPIKeyIndex, testAccountIndex)
+	if err != nil || c != replacement {
+		t.Errorf("get returned %p, %v, want the replacement client", c, err)
+	}
+	if c, _ := r.get(255, -1); c != replacement {
+		t.Error("most recently created client should be the default")
+	}
+	if c, _ := r.get(255, testAccountIndex); c != replacement {
+		t.Error("most recently created client should be the account default")
+	}
+}
+
+func TestClientRegistrySwap(t *testing.T) {
+	clients := newPipelineTestClients(t, 2)
+	r := newClientRegistry()
+
+	rotated := newRegistryTestClient(t, clients[0].apiKeyIndex)
+	if _, err := r.swap(rotated); err == nil {
+		t.Error("swap should fail for a pair which was never registered")
+	}
+
+	r.put(clients[0])
+	r.put(clients[1])
+	old, err := r.swap(rotated)
+	if err != nil {
+		t.Fatalf("swap failed: %v", err)
+	}
+	if old != clients[0] {
+		t.Error("swap should return the previously registered client")
+	}
+	if c, _ := r.get(testAPIKeyIndex, testAccountIndex); c != rotated {
+		t.Error("lookup should return the rotated client")
+	}
+	// rate limits follow the pair across rotations
+	rotated.SetRateLimit(RateLimit{Capacity: 1}, true)
+	if _, err := r.swap(clients[0]); err != nil {
+		t.Fatalf("swap failed: %v", err)
+	}
+	if clients[0].limits.Load() != rotated.limits.Load() {
+		t.Error("rate limit should be carried over from the replaced client")
+	}
+
+	// defaults are not moved by a rotation
+	if c, _ := r.get(255, -1); c != clients[1] {
+		t.Error("rotation should not change the default client")
+	}
+
+	// rate limits are also shared with a client created again for the pair
+	recreated := newRegistryTestClient(t, clients[0].apiKeyIndex)
+	r.put(recreated)
+	if recreated.limits.Load() == nil || recreated.limits.Load() != rotated.limits.Load() {
+		t.Error("rate limit should be shared by every client of the pair")
+	}
+}
+
+// BenchmarkClientRegistry reports the heap cost per registered client and the GetClient latency.
+func BenchmarkClientRegistry(b *testing.B) {
+	priv, _, err := GenerateAPIKey()
+	if err != nil {
+		b.Fatalf("GenerateAPIKey error: %v", err)
+	}
+
+	for _, n := range []int{1_000, 10_000, 100_000} {
+		b.Run(fmt.Sprintf("clients=%d", n), func(b *testing.B) {
+			var before, after runtime.MemStats
+			runtime.GC()
+			runtime.ReadMemStats(&before)
+
+			r := newClientRegistry()
+			for i := 0; i < n; i++ {
+				c, err := NewTxClient(nil, priv, int64(i/4+1), uint8(i%4), testChainID)
+				if err != nil {
+					b.Fatal(err)
+				}
+				r.put(c)
+			}
+
+			runtime.GC()
+			runtime.ReadMemStats(&after)
+			heapPerClient := float64(int64(after.HeapAlloc)-int64(before.HeapAlloc)) / float64(n)
+
+			b.ResetTimer()
+			for i := 0; i < b.N; i++ {
+				k := i % n
+				if _, err := r.get(uint8(k%4), int64(k/4+1)); err != nil {
+					b.Fatal(err)
+				}
+			}
+			b.ReportMetric(heapPerClient, "heap-B/client")
+			runtime.KeepAlive(r)
+		})
+	}
+}
+
+// BenchmarkClientRegistryRotation runs parallel lookups, with and without one goroutine continuously rotating
+// the looked up key, and reports the p99 & max lookup latency (power of 2 buckets) next to the rotations performed.
+func BenchmarkClientRegistryRotation(b *testing.B) {
+	for _, rotating := range []bool{false, true} {
+		b.Run(fmt.Sprintf("rotating=%v", rotating), func(b *testing.B) {
+			clients := newPipelineTestClients(b, 1)
+			versions := []*TxClient{clients[0], newRegistryTestClient(b, clients[0].apiKeyIndex)}
+
+			r := newClientRegistry()
+			r.put(clients[0])
+
+			var (
+				stop      atomic.Bool
+				rotations atomic.Int64
+				histMu    sync.Mutex
+				hist      [64]int64
+				wg        sync.WaitGroup
+			)
+			if rotating {
+				wg.Add(1)
+				go func() {
+					defer wg.Done()
+					for i := 0; !stop.Load(); i++ {
+						if _, err := r.swap(versions[i%2]); err != nil {
+							b.Error(err)
+							return
+						}
+						rotations.Add(1)
+					}
+				}()
+			}
+
+			b.ResetTimer()
+			b.RunParallel(func(pb *testing.PB) {
+				var local [64]int64
+				for pb.Next() {
+					start := time.Now()
+					if _, err := r.get(testAPIKeyIndex, testAccountIndex); err != nil {
+						b.Error(err)
+						return
+					}
+					local[bits.Len64(uint64(time.Since(start)))]++
+				}
+				histMu.Lock()
+				for i := range local {
+					hist[i] += local[i]
+				}
+				histMu.Unlock()
+			})
+			b.StopTimer()
+			stop.Store(true)
+			wg.Wait()
+
+			total, seen, p99, maxBucket := int64(0), int64(0), 0, 0
+			for i, n := range hist {
+				total += n
+				if n > 0 {
+					maxBucket = i
+				}
+			}
+			for i, n := range hist {
+				seen += n
+				if seen*100 >= total*99 {
+					p99 = i
+					break
+				}
+			}
+			b.ReportMetric(float64(uint64(1)<<p99), "p99-lookup-ns")
+			b.ReportMetric(float64(uint64(1)<<maxBucket), "max-lookup-ns")
+			b.ReportMetric(float64(rotations.Load()), "rotations")
+		})
+	}
+}
@@ -0,0 +1,123 @@
+package http
+
+import (
+	"encoding/json"
+	"fmt"
+	"net/http"
+	"net/http/httptest"
+	"runtime"
+	"sort"
+	"sync"
+	"testing"
+	"time"
+
+	core "github.com/elliottech/lighter-go/client"
+)
+
+// stubServerLatency stands in for the round trip & processing time of the real API
+const stubServerLatency = 200 * time.Microsecond
+
+func newStubTxServer(tb testing.TB) *httptest.Server {
+	tb.Helper()
+	mux := http.NewServeMux()
+	mux.HandleFunc("/api/v1/sendTx", func(w http.ResponseWriter, r *http.Request) {
+		time.Sleep(stubServerLatency)
+		_ = json.NewEncoder(w).Encode(TxHash{ResultCode: ResultCode{Code: CodeOK}, TxHash: "hash-" + r.FormValue("tx_info")})
+	})
+	mux.HandleFunc("/api/v1/sendTxBatch", func(w http.ResponseWriter, r *http.Request) {
+		time.Sleep(stubServerLatency)
+		var txInfos []string
+		if err := json.Unmarshal([]byte(r.FormValue("tx_infos")), &txInfos); err != nil {
+			_ = json.NewEncoder(w).Encode(ResultCode{Code: 400, Message: err.Error()})
+			return
+		}
+		result := TxHashes{ResultCode: ResultCode{Code: CodeOK}}
+		for _, info := range txInfos {
+			result.TxHashes = append(result.TxHashes, "hash-"+info)
+		}
+		_ = json.NewEncoder(w).Encode(result)
+	})
+	server := httptest.NewServer(mux)
+	tb.Cleanup(server.Close)
+	return server
+}
+
+func TestSendTxBatch(t *testing.T) {
+	server := newStubTxServer(t)
+	c := NewClient(server.URL).(core.TxSender)
+
+	hashes, err := c.SendTxBatch([]uint8{14, 15}, []string{`{"a":1}`, `{"b":2}`})
+	if err != nil {
+		t.Fatal(err)
+	}
+	if len(hashes) != 2 || hashes[0] != `hash-{"a":1}` || hashes[1] != `hash-{"b":2}` {
+		t.Errorf("hashes = %v", hashes)
+	}
+}
+
+// benchmarkSend runs b.N sends from `senders` goroutines, and reports the send latency percentiles & throughput.
+// With a single sender, the batched p50 shows the latency added when idle.
+func benchmarkSend(b *testing.B, senders int, send func(i int) error) {
+	var (
+		mu        sync.Mutex
+		latencies []time.Duration
+		next      int
+	)
+	b.SetParallelism((senders + runtime.GOMAXPROCS(0) - 1) / runtime.GOMAXPROCS(0))
+	b.ResetTimer()
+	start := time.Now()
+	b.RunParallel(func(pb *testing.PB) {
+		local := make([]time.Duration, 0, 1024)
+		for pb.Next() {
+			mu.Lock()
+			i := next
+			next++
+			mu.Unlock()
+
+			t0 := time.Now()
+			if err := send(i); err != nil {
+				b.Error(err)
+				return
+			}
+			local = append(local, time.Since(t0))
+		}
+		mu.Lock()
+		latencies = append(latencies, local...)
+		mu.Unlock()
+	})
+	elapsed := time.Since(start)
+	b.StopTimer()
+
+	sort.Slice(latencies, func(i, j int) bool { return latencies[i] < latencies[j] })
+	b.ReportMetric(float64(latencies[len(latencies)/2].Microseconds()), "p50-us")
+	b.ReportMetric(float64(latencies[len(latencies)*99/100].Microseconds()), "p99-us")
+	b.ReportMetric(float64(len(latencies))/elapsed.Seconds(), "txs/s")
+}
+
+func BenchmarkSendTxUnbatched(b *testing.B) {
+	for _, senders := range []int{1, 64} {
+		b.Run(fmt.Sprintf("senders=%d", senders), func(b *testing.B) {
+			c := NewClient(newStubTxServer(b).URL).(core.TxSender)
+			benchmarkSend(b, senders, func(i int) error {
+				_, err := c.SendTx(14, fmt.Sprint(i))
+				return err
+			})
+		})
+	}
+}
+
+func BenchmarkSendTxBatched(b *testing.B) {
+	for _, senders := range []int{1, 64} {
+		b.Run(fmt.Sprintf("senders=%d", senders), func(b *testing.B) {
+			c := NewClient(newStubTxServer(b).URL).(core.TxSender)
+			batcher := core.NewTxBatcher(c, core.BatcherConfig{})
+			benchmarkSend(b, senders, func(i int) error {
+				_, err := batcher.Send(14, fmt.Sprint(i))
+				return err
+			})
+			batcher.Close()
+			s := batcher.Stats()
+			b.ReportMetric(float64(s.Txs)/float64(s.Requests), "txs/request")
+		})
+	}
+}
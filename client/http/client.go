@@ -4,6 +4,7 @@ import (
 	"crypto/tls"
 	"net"
 	"net/http"
+	"sync"
 	"time"
 
 	core "github.com/elliottech/lighter-go/client"
@@ -31,18 +32,35 @@ var (
 	}
 )
 
-var _ core.MinimalHTTPClient = (*client)(nil)
+var (
+	_ core.MinimalHTTPClient = (*client)(nil)
+	_ core.TxSender          = (*client)(nil)
+)
 
 type client struct {
 	endpoint string
 }
 
+// clients are stateless apart from the endpoint, so a single instance is shared by every
+// TxClient pointing to the same endpoint
+var (
+	clientsMu sync.Mutex
+	clients   = make(map[string]*client)
+)
+
 func NewClient(baseUrl string) core.MinimalHTTPClient {
 	if baseUrl == "" {
 		return nil
 	}
 
-	return &client{
-		endpoint: baseUrl,
+	clientsMu.Lock()
+	defer clientsMu.Unlock()
+	c, ok := clients[baseUrl]
+	if !ok {
+		c = &client{
+			endpoint: baseUrl,
+		}
+		clients[baseUrl] = c
 	}
+	return c
 }
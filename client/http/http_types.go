@@ -25,3 +25,13 @@ type AccountApiKeys struct {
 	ResultCode
 	ApiKeys []*ApiKey `json:"api_keys"`
 }
+
+type TxHash struct {
+	ResultCode
+	TxHash string `json:"tx_hash"`
+}
+
+type TxHashes struct {
+	ResultCode
+	TxHashes []string `json:"tx_hash"`
+}
@@ -7,6 +7,7 @@ import (
 	"io"
 	"net/http"
 	"net/url"
+	"strconv"
 	"sync"
 )
 
@@ -54,6 +55,66 @@ func (c *client) getAndParseL2HTTPResponse(path string, params map[string]any, r
 	return nil
 }
 
+func (c *client) postAndParseL2HTTPResponse(path string, form url.Values, result any) error {
+	u, err := url.Parse(c.endpoint)
+	if err != nil {
+		return err
+	}
+	u.Path = path
+
+	resp, err := httpClient.PostForm(u.String(), form)
+	if err != nil {
+		return err
+	}
+	defer resp.Body.Close()
+	body, err := io.ReadAll(resp.Body)
+	if err != nil {
+		return err
+	}
+	if resp.StatusCode != http.StatusOK {
+		return errors.New(string(body))
+	}
+	if err = c.parseResultStatus(body); err != nil {
+		return err
+	}
+	return json.Unmarshal(body, result)
+}
+
+func (c *client) SendTx(txType uint8, txInfo string) (string, error) {
+	result := &TxHash{}
+	form := url.Values{"tx_type": {strconv.Itoa(int(txType))}, "tx_info": {txInfo}}
+	if err := c.postAndParseL2HTTPResponse("api/v1/sendTx", form, result); err != nil {
+		return "", err
+	}
+	return result.TxHash, nil
+}
+
+func (c *client) SendTxBatch(txTypes []uint8, txInfos []string) ([]string, error) {
+	// []uint8 would be encoded as base64 by encoding/json
+	txTypesInt := make([]int, len(txTypes))
+	for i, t := range txTypes {
+		txTypesInt[i] = int(t)
+	}
+	typesJSON, err := json.Marshal(txTypesInt)
+	if err != nil {
+		return nil, err
+	}
+	infosJSON, err := json.Marshal(txInfos)
+	if err != nil {
+		return nil, err
+	}
+
+	result := &TxHashes{}
+	form := url.Values{"tx_types": {string(typesJSON)}, "tx_infos": {string(infosJSON)}}
+	if err := c.postAndParseL2HTTPResponse("api/v1/sendTxBatch", form, result); err != nil {
+		return nil, err
+	}
+	if len(result.TxHashes) != len(txInfos) {
+		return nil, fmt.Errorf("sendTxBatch returned %d hashes for %d transactions", len(result.TxHashes), len(txInfos))
+	}
+	return result.TxHashes, nil
+}
+
 func (c *client) GetNextNonce(accountIndex int64, apiKeyIndex uint8) (int64, error) {
 	result := &NextNonce{}
 	err := c.getAndParseL2HTTPResponse("api/v1/nextNonce", map[string]any{"account_index": accountIndex, "api_key_index": apiKeyIndex}, result)
@@ -5,3 +5,9 @@ type MinimalHTTPClient interface {
 	GetApiKey(accountIndex int64, apiKeyIndex uint8) (string, error)
 	InvalidateApiKeys(accountIndex int64)
 }
+
+// TxSender submits signed transactions, see TxBatcher
+type TxSender interface {
+	SendTx(txType uint8, txInfo string) (string, error)
+	SendTxBatch(txTypes []uint8, txInfos []string) ([]string, error)
+}
@@ -0,0 +1,258 @@
+package client
+
+import (
+	"fmt"
+	"runtime"
+	"sort"
+	"sync"
+	"sync/atomic"
+	"time"
+
+	"github.com/elliottech/lighter-go/types"
+	"github.com/elliottech/lighter-go/types/txtypes"
+)
+
+// LadderLevel is one resting limit order of a target quote ladder
+type LadderLevel struct {
+	IsAsk      uint8
+	Price      uint32
+	BaseAmount int64
+}
+
+// LadderOrder is a live order of a ladder, identified by the ClientOrderIndex it was created with
+type LadderOrder struct {
+	ClientOrderIndex int64
+	LadderLevel
+}
+
+type LadderConfig struct {
+	// TimeInForce of created orders. Defaults to txtypes.PostOnly.
+	TimeInForce uint8
+	// OrderExpiry of created orders, from now. Defaults to 28 days.
+	OrderExpiry time.Duration
+	// FirstClientOrderIndex is the ClientOrderIndex of the first created order, the next ones are incremented.
+	// Defaults to the current unix time in ms, so indexes don't collide with a previous run.
+	FirstClientOrderIndex int64
+	// Workers signing the txs of a single update. Defaults to GOMAXPROCS.
+	Workers int
+}
+
+// LadderManager holds the live ladder of every market of a client's account, and turns target ladders into
+// the fewest Cancel, Modify & Create txs that transform the live ladder into the target.
+type LadderManager struct {
+	client *TxClient
+	cfg    LadderConfig
+
+	mu                   sync.Mutex
+	live                 map[int16][]LadderOrder
+	nextClientOrderIndex int64
+}
+
+func NewLadderManager(c *TxClient, cfg LadderConfig) *LadderManager {
+	if cfg.TimeInForce == 0 {
+		cfg.TimeInForce = txtypes.PostOnly
+	}
+	if cfg.OrderExpiry <= 0 {
+		cfg.OrderExpiry = 28 * 24 * time.Hour
+	}
+	if cfg.FirstClientOrderIndex <= 0 {
+		cfg.FirstClientOrderIndex = time.Now().UnixMilli()
+	}
+	if cfg.Workers <= 0 {
+		cfg.Workers = runtime.GOMAXPROCS(0)
+	}
+	return &LadderManager{
+		client:               c,
+		cfg:                  cfg,
+		live:                 make(map[int16][]LadderOrder),
+		nextClientOrderIndex: cfg.FirstClientOrderIndex,
+	}
+}
+
+// Live returns a copy of the live ladder of a market
+func (m *LadderManager) Live(marketIndex int16) []LadderOrder {
+	m.mu.Lock()
+	defer m.mu.Unlock()
+	return append([]LadderOrder(nil), m.live[marketIndex]...)
+}
+
+// SetLive replaces the live ladder of a market, e.g. after resyncing with the exchange when a tx was rejected.
+func (m *LadderManager) SetLive(marketIndex int16, orders []LadderOrder) {
+	m.mu.Lock()
+	defer m.mu.Unlock()
+	m.live[marketIndex] = append([]LadderOrder(nil), orders...)
+}
+
+type ladderModify struct {
+	order LadderOrder
+	level LadderLevel
+}
+
+type ladderPlan struct {
+	keep     []LadderOrder
+	cancels  []LadderOrder
+	modifies []ladderModify
+	creates  []LadderLevel
+}
+
+func (p *ladderPlan) txCount() int {
+	return len(p.cancels) + len(p.modifies) + len(p.creates)
+}
+
+// diffLadder computes the plan per side. Orders already at a target level are kept, the remaining ones are
+// matched with the remaining levels at the same price first (size change only), then in price order,
+// and whatever is left on either side is cancelled or created: max(unmatched live, unmatched target) txs.
+func diffLadder(live []LadderOrder, target []LadderLevel) ladderPlan {
+	var plan ladderPlan
+	for _, isAsk := range []uint8{0, 1} {
+		var orders []LadderOrder
+		var levels []LadderLevel
+		for _, o := range live {
+			if o.IsAsk == isAsk {
+				orders = append(orders, o)
+			}
+		}
+		for _, l := range target {
+			if l.IsAsk == isAsk {
+				levels = append(levels, l)
+			}
+		}
+
+		// exact matches, then same price
+		for _, samePrice := range []bool{false, true} {
+			for i := 0; i < len(levels); i++ {
+				for j := range orders {
+					if orders[j].Price != levels[i].Price || (!samePrice && orders[j].BaseAmount != levels[i].BaseAmount) {
+						continue
+					}
+					if samePrice {
+						plan.modifies = append(plan.modifies, ladderModify{order: orders[j], level: levels[i]})
+					} else {
+						plan.keep = append(plan.keep, orders[j])
+					}
+					orders = append(orders[:j], orders[j+1:]...)
+					levels = append(levels[:i], levels[i+1:]...)
+					i--
+					break
+				}
+			}
+		}
+
+		sort.Slice(orders, func(i, j int) bool { return orders[i].Price < orders[j].Price })
+		sort.Slice(levels, func(i, j int) bool { return levels[i].Price < levels[j].Price })
+		n := min(len(orders), len(levels))
+		for i := 0; i < n; i++ {
+			plan.modifies = append(plan.modifies, ladderModify{order: orders[i], level: levels[i]})
+		}
+		plan.cancels = append(plan.cancels, orders[n:]...)
+		plan.creates = append(plan.creates, levels[n:]...)
+	}
+
+	// orders moving away from the other side go first, so a moving ladder never crosses itself in between
+	sort.SliceStable(plan.modifies, func(i, j int) bool {
+		return plan.modifies[i].retreats() && !plan.modifies[j].retreats()
+	})
+	return plan
+}
+
+func (m ladderModify) retreats() bool {
+	if m.order.IsAsk == 1 {
+		return m.level.Price > m.order.Price
+	}
+	return m.level.Price < m.order.Price
+}
+
+// Update computes the txs turning the live ladder of marketIndex into target, and signs them in parallel.
+// Nonces are assigned from nonce onwards, cancels first (freeing margin & order slots), then modifies, then creates.
+// The returned txs are in nonce order and the next free nonce is returned.
+//
+// If any tx fails to be signed (e.g. ErrRateLimited), nothing is returned and the live ladder is unchanged.
+// Otherwise the live ladder becomes the target; if the exchange rejects some of the txs, resync it with SetLive.
+func (m *LadderManager) Update(marketIndex int16, target []LadderLevel, nonce int64) ([]txtypes.TxInfo, int64, error) {
+	m.mu.Lock()
+	defer m.mu.Unlock()
+
+	plan := diffLadder(m.live[marketIndex], target)
+	if plan.txCount() == 0 {
+		return nil, nonce, nil
+	}
+
+	expiredAt := time.Now().Add(DefaultExpireTime).UnixMilli()
+	orderExpiry := time.Now().Add(m.cfg.OrderExpiry).UnixMilli()
+	next := make([]LadderOrder, 0, len(target))
+	next = append(next, plan.keep...)
+
+	sign := make([]func(ops *types.TransactOpts) (txtypes.TxInfo, error), 0, plan.txCount())
+	for _, o := range plan.cancels {
+		req := &types.CancelOrderTxReq{MarketIndex: marketIndex, Index: o.ClientOrderIndex}
+		sign = append(sign, func(ops *types.TransactOpts) (txtypes.TxInfo, error) {
+			return m.client.GetCancelOrderTransaction(req, ops)
+		})
+	}
+	for _, mod := range plan.modifies {
+		req := &types.ModifyOrderTxReq{
+			MarketIndex: marketIndex,
+			Index:       mod.order.ClientOrderIndex,
+			BaseAmount:  mod.level.BaseAmount,
+			Price:       mod.level.Price,
+		}
+		sign = append(sign, func(ops *types.TransactOpts) (txtypes.TxInfo, error) {
+			return m.client.GetModifyOrderTransaction(req, ops)
+		})
+		next = append(next, LadderOrder{ClientOrderIndex: mod.order.ClientOrderIndex, LadderLevel: mod.level})
+	}
+	clientOrderIndex := m.nextClientOrderIndex
+	for _, level := range plan.creates {
+		req := &types.CreateOrderTxReq{
+			MarketIndex:      marketIndex,
+			ClientOrderIndex: clientOrderIndex,
+			BaseAmount:       level.BaseAmount,
+			Price:            level.Price,
+			IsAsk:            level.IsAsk,
+			Type:             txtypes.LimitOrder,
+			TimeInForce:      m.cfg.TimeInForce,
+			OrderExpiry:      orderExpiry,
+		}
+		sign = append(sign, func(ops *types.TransactOpts) (txtypes.TxInfo, error) {
+			return m.client.GetCreateOrderTransaction(req, ops)
+		})
+		next = append(next, LadderOrder{ClientOrderIndex: clientOrderIndex, LadderLevel: level})
+		clientOrderIndex++
+	}
+
+	txs := make([]txtypes.TxInfo, len(sign))
+	errs := make([]error, len(sign))
+	signOne := func(i int) {
+		txNonce := nonce + int64(i)
+		txs[i], errs[i] = sign[i](&types.TransactOpts{Nonce: &txNonce, ExpiredAt: expiredAt})
+	}
+	if workers := min(m.cfg.Workers, len(sign)); workers <= 1 {
+		for i := range sign {
+			signOne(i)
+		}
+	} else {
+		var (
+			nextTx atomic.Int64
+			wg     sync.WaitGroup
+		)
+		for w := 0; w < workers; w++ {
+			wg.Add(1)
+			go func() {
+				defer wg.Done()
+				for i := int(nextTx.Add(1)) - 1; i < len(sign); i = int(nextTx.Add(1)) - 1 {
+					signOne(i)
+				}
+			}()
+		}
+		wg.Wait()
+	}
+	for i, err := range errs {
+		if err != nil {
+			return nil, nonce, fmt.Errorf("ladder tx %d of %d: %w", i, len(sign), err)
+		}
+	}
+
+	m.live[marketIndex] = next
+	m.nextClientOrderIndex = clientOrderIndex
+	return txs, nonce + int64(len(txs)), nil
+}
@@ -0,0 +1,154 @@
+package client
+
+import (
+	"math/rand"
+	"testing"
+
+	"github.com/elliottech/lighter-go/types/txtypes"
+)
+
+// ladderLevels returns `levels` bids below mid and asks above it, one tick apart
+func ladderLevels(mid uint32, levels int, size func(i int) int64) []LadderLevel {
+	ladder := make([]LadderLevel, 0, 2*levels)
+	for i := 0; i < levels; i++ {
+		ladder = append(ladder,
+			LadderLevel{IsAsk: 0, Price: mid - uint32(i+1), BaseAmount: size(i)},
+			LadderLevel{IsAsk: 1, Price: mid + uint32(i+1), BaseAmount: size(i)},
+		)
+	}
+	return ladder
+}
+
+func TestLadderDiff(t *testing.T) {
+	live := []LadderOrder{
+		{ClientOrderIndex: 1, LadderLevel: LadderLevel{IsAsk: 0, Price: 99, BaseAmount: 10}},
+		{ClientOrderIndex: 2, LadderLevel: LadderLevel{IsAsk: 0, Price: 98, BaseAmount: 10}},
+		{ClientOrderIndex: 3, LadderLevel: LadderLevel{IsAsk: 1, Price: 101, BaseAmount: 10}},
+		{ClientOrderIndex: 4, LadderLevel: LadderLevel{IsAsk: 1, Price: 102, BaseAmount: 10}},
+		{ClientOrderIndex: 5, LadderLevel: LadderLevel{IsAsk: 1, Price: 103, BaseAmount: 10}},
+	}
+	target := []LadderLevel{
+		{IsAsk: 0, Price: 99, BaseAmount: 10},  // kept
+		{IsAsk: 0, Price: 98, BaseAmount: 20},  // size modify
+		{IsAsk: 0, Price: 97, BaseAmount: 10},  // create
+		{IsAsk: 1, Price: 102, BaseAmount: 10}, // kept
+		{IsAsk: 1, Price: 104, BaseAmount: 10}, // 101 or 103 moves here, the other one is cancelled
+	}
+
+	plan := diffLadder(live, target)
+	if len(plan.keep) != 2 || len(plan.modifies) != 2 || len(plan.creates) != 1 || len(plan.cancels) != 1 {
+		t.Fatalf("plan: keep %d, modify %d, create %d, cancel %d", len(plan.keep), len(plan.modifies), len(plan.creates), len(plan.cancels))
+	}
+	if !plan.modifies[0].retreats() {
+		t.Error("the ask moving up should be modified first")
+	}
+	if plan.creates[0].Price != 97 {
+		t.Errorf("created %+v", plan.creates[0])
+	}
+}
+
+func TestLadderManagerUpdate(t *testing.T) {
+	c := newPipelineTestClients(t, 1)[0]
+	m := NewLadderManager(c, LadderConfig{FirstClientOrderIndex: 1000, Workers: 4})
+
+	target := ladderLevels(1000, 5, func(int) int64 { return 100 })
+	txs, nonce, err := m.Update(0, target, 7)
+	if err != nil {
+		t.Fatal(err)
+	}
+	if len(txs) != 10 || nonce != 17 {
+		t.Fatalf("%d txs, next nonce %d", len(txs), nonce)
+	}
+	for i, tx := range txs {
+		create, ok := tx.(*txtypes.L2CreateOrderTxInfo)
+		if !ok {
+			t.Errorf("tx %d: %T, want a create", i, tx)
+		} else if create.Nonce != int64(7+i) {
+			t.Errorf("tx %d: nonce %d, want %d", i, create.Nonce, 7+i)
+		}
+	}
+
+	// mid moves up by one tick: the outermost bid & the innermost ask are cancelled & created, or moved
+	txs, nonce, err = m.Update(0, ladderLevels(1001, 5, func(int) int64 { return 100 }), nonce)
+	if err != nil {
+		t.Fatal(err)
+	}
+	if len(txs) != 2 || nonce != 19 {
+		t.Fatalf("%d txs, next nonce %d", len(txs), nonce)
+	}
+	for i, tx := range txs {
+		if tx.GetTxType() != txtypes.TxTypeL2ModifyOrder {
+			t.Errorf("tx %d: type %d, want a modify", i, tx.GetTxType())
+		}
+	}
+	if live := m.Live(0); len(live) != 10 {
+		t.Errorf("%d live orders", len(live))
+	}
+
+	// nothing to do
+	if txs, nonce2, err := m.Update(0, ladderLevels(1001, 5, func(int) int64 { return 100 }), nonce); err != nil || len(txs) != 0 || nonce2 != nonce {
+		t.Errorf("no-op update: %d txs, nonce %d, %v", len(txs), nonce2, err)
+	}
+}
+
+// ladderChurn produces target ladders of 10 levels per side: every tick the mid moves by -1, 0 or +1 ticks
+// and ~20% of the levels change size
+func ladderChurn(ticks int) [][]LadderLevel {
+	rng := rand.New(rand.NewSource(1))
+	mid := uint32(100_000)
+	sizes := make([]int64, 10)
+	for i := range sizes {
+		sizes[i] = 1000
+	}
+	targets := make([][]LadderLevel, ticks)
+	for t := range targets {
+		mid = uint32(int(mid) + rng.Intn(3) - 1)
+		for i := range sizes {
+			if rng.Intn(5) == 0 {
+				sizes[i] = int64(500 + rng.Intn(1000))
+			}
+		}
+		targets[t] = ladderLevels(mid, len(sizes), func(i int) int64 { return sizes[i] })
+	}
+	return targets
+}
+
+// BenchmarkLadderUpdate reports the txs signed per tick with the diff, next to replacing the whole ladder
+// (cancel every order & create the target) which is what the diff saves.
+func BenchmarkLadderUpdate(b *testing.B) {
+	c := newPipelineTestClients(b, 1)[0]
+	targets := ladderChurn(1000)
+
+	b.Run("diff", func(b *testing.B) {
+		m := NewLadderManager(c, LadderConfig{})
+		nonce, txs := int64(0), 0
+		b.ResetTimer()
+		for i := 0; i < b.N; i++ {
+			signed, next, err := m.Update(0, targets[i%len(targets)], nonce)
+			if err != nil {
+				b.Fatal(err)
+			}
+			nonce, txs = next, txs+len(signed)
+		}
+		b.ReportMetric(float64(txs)/float64(b.N), "txs/tick")
+	})
+
+	b.Run("replace", func(b *testing.B) {
+		m := NewLadderManager(c, LadderConfig{})
+		nonce, txs := int64(0), 0
+		b.ResetTimer()
+		for i := 0; i < b.N; i++ {
+			// an empty target cancels everything, then the target is created from scratch
+			cancelled, next, err := m.Update(0, nil, nonce)
+			if err != nil {
+				b.Fatal(err)
+			}
+			created, next, err := m.Update(0, targets[i%len(targets)], next)
+			if err != nil {
+				b.Fatal(err)
+			}
+			nonce, txs = next, txs+len(cancelled)+len(created)
+		}
+		b.ReportMetric(float64(txs)/float64(b.N), "txs/tick")
+	})
+}
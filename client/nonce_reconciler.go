@@ -0,0 +1,273 @@
+package client
+
+import (
+	"fmt"
+	"sort"
+	"sync"
+
+	"github.com/elliottech/lighter-go/types"
+	"github.com/elliottech/lighter-go/types/txtypes"
+)
+
+// TxStatus is the outcome of a sent transaction, as reported by the API or the websocket
+type TxStatus uint8
+
+const (
+	// TxAccepted transactions consumed their nonce
+	TxAccepted TxStatus = iota
+	// TxRejected transactions were refused before execution and didn't consume their nonce
+	TxRejected
+)
+
+type TxResult struct {
+	Nonce  int64
+	TxHash string
+	Status TxStatus
+}
+
+type NonceRecovery uint8
+
+const (
+	// NonceRewind hands a rejected nonce back to Next. If later nonces are in flight they can't be executed anymore,
+	// so they are dropped (counted in Orphaned) and their results ignored; the caller re-signs them.
+	NonceRewind NonceRecovery = iota
+	// NonceFill keeps the later nonces valid by signing a no-op transaction at the rejected nonce, which Ingest returns
+	// for the caller to send. The rejected nonce is only handed back to Next when nothing was assigned after it.
+	NonceFill
+)
+
+type NonceReconcilerConfig struct {
+	// Next is the next nonce to assign. If negative, it's fetched once with GetNextNonce.
+	Next int64
+	// Recovery applied when a rejection leaves a gap below nonces in flight. Defaults to NonceRewind.
+	Recovery NonceRecovery
+	// Filler signs the no-op transaction filling a gap with NonceFill. It must not set SkipNonce, as the transaction
+	// has to consume the nonce. Defaults to cancelling an order index that can't exist on FillMarketIndex.
+	Filler          func(nonce int64) (txtypes.TxInfo, error)
+	FillMarketIndex int16
+}
+
+type NonceState struct {
+	// Next is the nonce the next call to Next returns
+	Next int64
+	// InFlight is the number of assigned nonces without a result yet
+	InFlight int
+	// Gaps are rejected nonces below nonces in flight which couldn't be filled yet, in ascending order
+	Gaps []int64
+
+	Accepted uint64
+	Rejected uint64
+	Rewinds  uint64
+	Fills    uint64
+	Orphaned uint64
+	// Ignored results didn't match a nonce in flight: stale results of orphaned txs, or txs signed with SkipNonce
+	Ignored uint64
+}
+
+// NonceReconciler assigns the nonces of an (account, apiKey) pair and keeps the local sequence consistent with the
+// results of the sent transactions, so a rejection is recovered from locally instead of resyncing with GetNextNonce.
+//
+// Transactions signed with the SkipNonce attribute don't take a place in the sequence: don't call Next for them,
+// their results don't match any nonce in flight and are ignored.
+type NonceReconciler struct {
+	client *TxClient
+	cfg    NonceReconcilerConfig
+
+	mu       sync.Mutex
+	next     int64
+	inFlight map[int64]string // nonce -> tx hash, empty until Track
+	gaps     map[int64]struct{}
+	state    NonceState
+}
+
+func NewNonceReconciler(c *TxClient, cfg NonceReconcilerConfig) (*NonceReconciler, error) {
+	if cfg.Next < 0 {
+		if c.apiClient == nil {
+			return nil, fmt.Errorf("nonce was not provided & HTTPClient is nil")
+		}
+		next, err := c.apiClient.GetNextNonce(c.accountIndex, c.apiKeyIndex)
+		if err != nil {
+			return nil, err
+		}
+		cfg.Next = next
+	}
+	r := &NonceReconciler{
+		client:   c,
+		cfg:      cfg,
+		next:     cfg.Next,
+		inFlight: make(map[int64]string),
+		gaps:     make(map[int64]struct{}),
+	}
+	if r.cfg.Filler == nil {
+		r.cfg.Filler = r.cancelFiller
+	}
+	return r, nil
+}
+
+func (r *NonceReconciler) cancelFiller(nonce int64) (txtypes.TxInfo, error) {
+	// not rate limited: the gap blocks every later nonce until it's filled
+	return r.client.signUnmetered(
+		&types.CancelOrderTxReq{MarketIndex: r.cfg.FillMarketIndex, Index: txtypes.MaxOrderIndex},
+		&types.TransactOpts{Nonce: &nonce},
+	)
+}
+
+// Next assigns the next nonce. Once the transaction is signed, record its hash with Track;
+// if signing fails, hand the nonce back with Ingest(TxResult{Nonce: nonce, Status: TxRejected}).
+func (r *NonceReconciler) Next() int64 {
+	r.mu.Lock()
+	defer r.mu.Unlock()
+	nonce := r.next
+	r.next++
+	r.inFlight[nonce] = ""
+	return nonce
+}
+
+// Track records the hash of the transaction signed with an assigned nonce, so stale results can be told apart.
+func (r *NonceReconciler) Track(nonce int64, txHash string) {
+	r.mu.Lock()
+	defer r.mu.Unlock()
+	if _, ok := r.inFlight[nonce]; ok {
+		r.inFlight[nonce] = txHash
+	}
+}
+
+// Reset drops everything in flight and restarts the sequence at next, e.g. after the nonce was used by another
+// process and had to be fetched again.
+func (r *NonceReconciler) Reset(next int64) {
+	r.mu.Lock()
+	defer r.mu.Unlock()
+	r.state.Orphaned += uint64(len(r.inFlight))
+	r.next = next
+	clear(r.inFlight)
+	clear(r.gaps)
+}
+
+func (r *NonceReconciler) State() NonceState {
+	r.mu.Lock()
+	defer r.mu.Unlock()
+	s := r.state
+	s.Next = r.next
+	s.InFlight = len(r.inFlight)
+	s.Gaps = make([]int64, 0, len(r.gaps))
+	for nonce := range r.gaps {
+		s.Gaps = append(s.Gaps, nonce)
+	}
+	sort.Slice(s.Gaps, func(i, j int) bool { return s.Gaps[i] < s.Gaps[j] })
+	return s
+}
+
+// Ingest applies the result of a transaction. With NonceFill, a rejection below nonces in flight returns the signed
+// no-op filling the gap, which must be sent; it's already tracked, so its result should be ingested as well.
+// If signing it fails, the error is returned and the nonce stays in State().Gaps until FillGaps succeeds.
+func (r *NonceReconciler) Ingest(res TxResult) (txtypes.TxInfo, error) {
+	r.mu.Lock()
+	txHash, ok := r.inFlight[res.Nonce]
+	if !ok || (txHash != "" && res.TxHash != "" && txHash != res.TxHash) {
+		r.state.Ignored++
+		r.mu.Unlock()
+		return nil, nil
+	}
+	delete(r.inFlight, res.Nonce)
+
+	if res.Status == TxAccepted {
+		r.state.Accepted++
+		r.mu.Unlock()
+		return nil, nil
+	}
+	r.state.Rejected++
+	r.gaps[res.Nonce] = struct{}{}
+	if r.rewind() || r.cfg.Recovery == NonceRewind {
+		r.mu.Unlock()
+		return nil, nil
+	}
+	// reserve the gap while signing outside the lock
+	delete(r.gaps, res.Nonce)
+	r.inFlight[res.Nonce] = ""
+	r.mu.Unlock()
+
+	return r.fill(res.Nonce)
+}
+
+// FillGaps signs a no-op for every gap left by a failed fill, see Ingest.
+func (r *NonceReconciler) FillGaps() ([]txtypes.TxInfo, error) {
+	r.mu.Lock()
+	nonces := make([]int64, 0, len(r.gaps))
+	for nonce := range r.gaps {
+		nonces = append(nonces, nonce)
+		delete(r.gaps, nonce)
+		r.inFlight[nonce] = ""
+	}
+	r.mu.Unlock()
+	sort.Slice(nonces, func(i, j int) bool { return nonces[i] < nonces[j] })
+
+	var (
+		txs      []txtypes.TxInfo
+		firstErr error
+	)
+	for _, nonce := range nonces {
+		tx, err := r.fill(nonce)
+		if err != nil {
+			if firstErr == nil {
+				firstErr = err
+			}
+			continue
+		}
+		txs = append(txs, tx)
+	}
+	return txs, firstErr
+}
+
+func (r *NonceReconciler) fill(nonce int64) (txtypes.TxInfo, error) {
+	tx, err := r.cfg.Filler(nonce)
+
+	r.mu.Lock()
+	defer r.mu.Unlock()
+	if _, ok := r.inFlight[nonce]; !ok {
+		// Reset meanwhile
+		return nil, nil
+	}
+	if err != nil {
+		delete(r.inFlight, nonce)
+		r.gaps[nonce] = struct{}{}
+		r.rewind()
+		return nil, fmt.Errorf("failed to fill nonce %d: %w", nonce, err)
+	}
+	r.inFlight[nonce] = tx.GetTxHash()
+	r.state.Fills++
+	return tx, nil
+}
+
+// rewind hands the gaps at the end of the sequence back to Next. With NonceRewind, gaps below nonces in flight
+// orphan them and the sequence restarts at the lowest gap. Reports whether no gap is left.
+// Must be called with the lock held.
+func (r *NonceReconciler) rewind() bool {
+	rewound := false
+	for {
+		if _, ok := r.gaps[r.next-1]; !ok {
+			break
+		}
+		delete(r.gaps, r.next-1)
+		r.next--
+		rewound = true
+	}
+	if len(r.gaps) > 0 && r.cfg.Recovery == NonceRewind {
+		lowest := r.next
+		for nonce := range r.gaps {
+			lowest = min(lowest, nonce)
+		}
+		for nonce := range r.inFlight {
+			if nonce > lowest {
+				delete(r.inFlight, nonce)
+				r.state.Orphaned++
+			}
+		}
+		clear(r.gaps)
+		r.next = lowest
+		rewound = true
+	}
+	if rewound {
+		r.state.Rewinds++
+	}
+	return len(r.gaps) == 0
+}
@@ -0,0 +1,105 @@
+package client
+
+import (
+	"testing"
+
+	"github.com/elliottech/lighter-go/types/txtypes"
+)
+
+func TestNonceReconcilerRewind(t *testing.T) {
+	c := newPipelineTestClients(t, 1)[0]
+	r, err := NewNonceReconciler(c, NonceReconcilerConfig{Next: 10})
+	if err != nil {
+		t.Fatal(err)
+	}
+	for i := 0; i < 4; i++ {
+		r.Track(r.Next(), "hash")
+	}
+
+	// the last nonce is rejected: it's simply handed back
+	if _, err := r.Ingest(TxResult{Nonce: 13, TxHash: "hash", Status: TxRejected}); err != nil {
+		t.Fatal(err)
+	}
+	if s := r.State(); s.Next != 13 || s.InFlight != 3 || s.Orphaned != 0 {
+		t.Fatalf("state = %+v", s)
+	}
+
+	// a rejection below nonces in flight orphans them
+	if _, err := r.Ingest(TxResult{Nonce: 11, TxHash: "hash", Status: TxRejected}); err != nil {
+		t.Fatal(err)
+	}
+	if s := r.State(); s.Next != 11 || s.InFlight != 1 || s.Orphaned != 1 || len(s.Gaps) != 0 {
+		t.Fatalf("state = %+v", s)
+	}
+	if nonce := r.Next(); nonce != 11 {
+		t.Errorf("Next = %d, want 11", nonce)
+	}
+	r.Track(11, "new")
+
+	// the result of the orphaned tx signed with 12 and of the old tx signed with 11 are ignored
+	_, _ = r.Ingest(TxResult{Nonce: 12, TxHash: "hash", Status: TxAccepted})
+	_, _ = r.Ingest(TxResult{Nonce: 11, TxHash: "hash", Status: TxAccepted})
+	_, _ = r.Ingest(TxResult{Nonce: 10, TxHash: "hash", Status: TxAccepted})
+	if s := r.State(); s.Ignored != 2 || s.Accepted != 1 || s.InFlight != 1 {
+		t.Errorf("state = %+v", s)
+	}
+}
+
+func TestNonceReconcilerFill(t *testing.T) {
+	c := newPipelineTestClients(t, 1)[0]
+	// fillers bypass the rate limit: the gap would block every later nonce
+	c.SetRateLimit(RateLimit{}, true)
+	r, err := NewNonceReconciler(c, NonceReconcilerConfig{Next: 10, Recovery: NonceFill})
+	if err != nil {
+		t.Fatal(err)
+	}
+	for i := 0; i < 3; i++ {
+		r.Next()
+	}
+
+	fill, err := r.Ingest(TxResult{Nonce: 10, Status: TxRejected})
+	if err != nil {
+		t.Fatal(err)
+	}
+	cancel, ok := fill.(*txtypes.L2CancelOrderTxInfo)
+	if !ok || cancel.Nonce != 10 || cancel.Index != txtypes.MaxOrderIndex || cancel.L2TxAttributes[txtypes.AttributeTypeSkipTxNonce] != 0 {
+		t.Fatalf("fill = %+v", fill)
+	}
+	if s := r.State(); s.Next != 13 || s.InFlight != 3 || s.Fills != 1 {
+		t.Fatalf("state = %+v", s)
+	}
+
+	// once nothing is in flight after a rejected nonce, it's handed back instead of filled
+	if fill, _ := r.Ingest(TxResult{Nonce: 12, Status: TxRejected}); fill != nil {
+		t.Errorf("the last nonce was filled")
+	}
+	if s := r.State(); s.Next != 12 {
+		t.Errorf("state = %+v", s)
+	}
+
+	_, _ = r.Ingest(TxResult{Nonce: 10, TxHash: cancel.GetTxHash(), Status: TxAccepted})
+	if s := r.State(); s.InFlight != 1 || s.Accepted != 1 {
+		t.Errorf("state = %+v", s)
+	}
+}
+
+// BenchmarkNonceReconcilerRecovery measures recovering from a rejection at the end of the sequence,
+// which replaces a GetNextNonce round trip.
+func BenchmarkNonceReconcilerRecovery(b *testing.B) {
+	c := newPipelineTestClients(b, 1)[0]
+	r, err := NewNonceReconciler(c, NonceReconcilerConfig{})
+	if err != nil {
+		b.Fatal(err)
+	}
+	for i := 0; i < 64; i++ {
+		r.Next()
+	}
+	b.ReportAllocs()
+	b.ResetTimer()
+	for i := 0; i < b.N; i++ {
+		nonce := r.Next()
+		if _, err := r.Ingest(TxResult{Nonce: nonce, Status: TxRejected}); err != nil {
+			b.Fatal(err)
+		}
+	}
+}
@@ -0,0 +1,404 @@
+package client
+
+import (
+	"errors"
+	"fmt"
+	"runtime"
+	"sync"
+	"sync/atomic"
+	"time"
+
+	p2 "github.com/elliottech/poseidon_crypto/hash/poseidon2_goldilocks"
+	ethCommon "github.com/ethereum/go-ethereum/common"
+
+	"github.com/elliottech/lighter-go/archive"
+	"github.com/elliottech/lighter-go/types"
+	"github.com/elliottech/lighter-go/types/txtypes"
+)
+
+// PipelineRequest is a single transaction submitted to a SignPipeline.
+// Tx must be one of the order-flow requests: *types.CreateOrderTxReq, *types.CreateGroupedOrdersTxReq,
+// *types.ModifyOrderTxReq, *types.CancelOrderTxReq or *types.CancelAllOrdersTxReq.
+type PipelineRequest struct {
+	Client *TxClient
+	Tx     any
+	Ops    *types.TransactOpts
+	// Deadline after which the request isn't worth signing anymore, zero for none.
+	// It's checked before converting & hashing and before signing; expired requests are emitted with ErrDeadlineExceeded.
+	// With PipelineConfig.Coalesce, it's only checked when the request leaves the queue, before it's given a nonce.
+	Deadline time.Time
+
+	// Tag is not interpreted by the pipeline; it's echoed back in the matching PipelineResult
+	Tag any
+}
+
+type PipelineResult struct {
+	Tag    any
+	TxInfo txtypes.TxInfo
+	TxJSON string
+	Err    error
+}
+
+var (
+	// ErrDeadlineExceeded is the error of requests dropped because they were still queued at their Deadline.
+	// Unless the pipeline coalesces, their nonce was resolved but not used: the later requests of the same API key
+	// fail with ErrNonceGap until it's submitted again (see NonceReconciler).
+	ErrDeadlineExceeded = errors.New("sign request deadline exceeded, transaction was not signed")
+	// ErrNonceGap is the error of requests which weren't signed because an earlier nonce of the same API key was
+	// resolved but not signed (dropped at its Deadline, rate limited or invalid), so the exchange would reject them.
+	// Submitting a request with that nonce, or an earlier one, lets the following requests of the key through again;
+	// with PipelineConfig.Coalesce, the nonce is assigned again to the next request of the key.
+	ErrNonceGap = errors.New("an earlier nonce of the API key was not signed, transaction was not signed")
+	// ErrCoalesced is the error of requests superseded by a later one for the same order, see PipelineConfig.Coalesce
+	ErrCoalesced = errors.New("sign request superseded by a later request for the same order, transaction was not signed")
+)
+
+type PipelineStats struct {
+	// Requests dropped at their Deadline, per stage they didn't enter
+	DroppedBeforeHash uint64
+	DroppedBeforeSign uint64
+	// Requests failed with ErrNonceGap
+	FailedAfterGap uint64
+	// Signed txs which PipelineConfig.Archive failed to append
+	ArchiveFailed uint64
+
+	// CoalescedModifies were replaced by a later ModifyOrder, CoalescedByCancel were ModifyOrders dropped by a
+	// CancelOrder of the same order, and CoalescedCancels were duplicates of a pending CancelOrder.
+	CoalescedModifies uint64
+	CoalescedByCancel uint64
+	CoalescedCancels  uint64
+}
+
+type PipelineConfig struct {
+	// Workers per stage. Defaults to GOMAXPROCS.
+	Workers int
+	// MaxInFlight bounds the number of requests that were submitted but not yet emitted. Defaults to 1024.
+	MaxInFlight int
+
+	// Coalesce keeps requests queued until the pipeline has room for them instead of resolving them in Submit,
+	// so that a ModifyOrder replaces the one still queued for the same (MarketIndex, Index), and a CancelOrder drops
+	// the ModifyOrder queued for its order. Superseded requests are emitted with ErrCoalesced.
+	// Nonces are assigned when requests leave the queue, so coalescing leaves no gaps; requests must not set one.
+	// The request is then validated and charged to the rate limit, and hands its nonce back if either fails.
+	// A request failing later is followed by ErrNonceGap for the requests of its key already past the queue,
+	// and its nonce goes to the next request of the key.
+	// Up to MaxInFlight requests are queued on top of the MaxInFlight ones being signed.
+	Coalesce bool
+	// NextNonce returns the first nonce of an (account, apiKey) pair, with Coalesce; the following ones are counted
+	// locally. Defaults to calling GetNextNonce.
+	NextNonce func(c *TxClient) (int64, error)
+
+	// Archive, if set, gets every signed tx it can store (all but grouped orders), in the order results are emitted.
+	// Append errors are counted in PipelineStats.ArchiveFailed and don't fail the result. The caller closes the writer
+	// once Results is drained.
+	Archive *archive.Writer
+}
+
+type pipelineJob struct {
+	seq     uint64
+	req     PipelineRequest
+	tx      txtypes.TxInfo
+	msgHash []byte
+	result  PipelineResult
+	// nonce sequence of the job's API key, see pipelineGaps
+	epoch uint64
+	// the rate limit was charged by the coalescing dispatcher
+	admitted bool
+}
+
+// SignPipeline splits signing into 3 stages (convert+validate+hash, sign, JSON encode), each running on its own
+// pool of goroutines and connected through bounded channels.
+// Nonces are resolved in Submit, in submission order, and results are emitted in the same order,
+// so for any (account, apiKey) pair results come out in nonce order.
+// With PipelineConfig.Coalesce, nonces are assigned when requests leave the queue instead, in the same order.
+type SignPipeline struct {
+	submitMu sync.Mutex
+	closed   bool
+	nextSeq  uint64
+
+	slots    chan struct{}
+	prepared chan *pipelineJob
+	hashed   chan *pipelineJob
+	signed   chan *pipelineJob
+	encoded  chan *pipelineJob
+	results  chan PipelineResult
+
+	// nil unless PipelineConfig.Coalesce
+	coalescer *pipelineCoalescer
+	gaps      *pipelineGaps
+	archive   *archive.Writer
+
+	droppedBeforeHash atomic.Uint64
+	droppedBeforeSign atomic.Uint64
+	failedAfterGap    atomic.Uint64
+	archiveFailed     atomic.Uint64
+}
+
+func NewSignPipeline(cfg PipelineConfig) *SignPipeline {
+	if cfg.Workers <= 0 {
+		cfg.Workers = runtime.GOMAXPROCS(0)
+	}
+	if cfg.MaxInFlight <= 0 {
+		cfg.MaxInFlight = 1024
+	}
+
+	p := &SignPipeline{
+		slots:    make(chan struct{}, cfg.MaxInFlight),
+		prepared: make(chan *pipelineJob, cfg.MaxInFlight),
+		hashed:   make(chan *pipelineJob, cfg.MaxInFlight),
+		signed:   make(chan *pipelineJob, cfg.MaxInFlight),
+		encoded:  make(chan *pipelineJob, cfg.MaxInFlight),
+		results:  make(chan PipelineResult, cfg.MaxInFlight),
+		gaps:     newPipelineGaps(),
+		archive:  cfg.Archive,
+	}
+	if cfg.Coalesce {
+		p.coalescer = newPipelineCoalescer(cfg.MaxInFlight, cfg.NextNonce)
+	}
+
+	p.startStage(cfg.Workers, p.prepared, p.hashed, &p.droppedBeforeHash, hashPipelineJob)
+	p.startStage(cfg.Workers, p.hashed, p.signed, &p.droppedBeforeSign, signPipelineJob)
+	p.startStage(cfg.Workers, p.signed, p.encoded, nil, encodePipelineJob)
+	go p.emit()
+	if p.coalescer != nil {
+		go p.dispatch()
+	}
+
+	return p
+}
+
+// Submit fills the default ops (which may call GetNextNonce if no nonce was provided) and enqueues the request.
+// It blocks while MaxInFlight requests are pending.
+// With Coalesce, the ops are filled when the request leaves the queue, and Submit only blocks while the queue is full.
+func (p *SignPipeline) Submit(req PipelineRequest) error {
+	if req.Client == nil {
+		return fmt.Errorf("pipeline request has no client")
+	}
+
+	p.submitMu.Lock()
+	defer p.submitMu.Unlock()
+	if p.closed {
+		return fmt.Errorf("pipeline is closed")
+	}
+
+	if p.coalescer != nil {
+		return p.coalescer.submit(req)
+	}
+	ops, err := req.Client.FullFillDefaultOps(req.Ops)
+	if err != nil {
+		return err
+	}
+	req.Ops = ops
+
+	job := &pipelineJob{seq: p.nextSeq, req: req}
+	p.gaps.submitted(job)
+	p.slots <- struct{}{}
+	p.prepared <- job
+	p.nextSeq++
+	return nil
+}
+
+// Results returns the channel on which signed transactions are emitted. It's closed after Close drains the pipeline.
+func (p *SignPipeline) Results() <-chan PipelineResult {
+	return p.results
+}
+
+// Close stops accepting new requests. Pending requests are still signed and emitted.
+// Results must keep being consumed until the channel is closed.
+func (p *SignPipeline) Close() {
+	p.submitMu.Lock()
+	defer p.submitMu.Unlock()
+	if p.closed {
+		return
+	}
+	p.closed = true
+	if p.coalescer != nil {
+		// the dispatcher closes prepared once the queue is drained
+		p.coalescer.close()
+		return
+	}
+	close(p.prepared)
+}
+
+func (p *SignPipeline) Stats() PipelineStats {
+	s := PipelineStats{
+		DroppedBeforeHash: p.droppedBeforeHash.Load(),
+		DroppedBeforeSign: p.droppedBeforeSign.Load(),
+		FailedAfterGap:    p.failedAfterGap.Load(),
+		ArchiveFailed:     p.archiveFailed.Load(),
+	}
+	if p.coalescer != nil {
+		s.CoalescedModifies = p.coalescer.modifies.Load()
+		s.CoalescedByCancel = p.coalescer.byCancel.Load()
+		s.CoalescedCancels = p.coalescer.cancels.Load()
+	}
+	return s
+}
+
+// startStage runs fn on the jobs from in. If dropped is set, jobs past their deadline, or behind a nonce gap, skip fn.
+// When coalescing, deadlines are only checked by the dispatcher: past it, jobs hold a nonce and dropping them would leave a gap.
+// A job failing here leaves a gap, and the later jobs of its key fail fast with ErrNonceGap.
+func (p *SignPipeline) startStage(workers int, in <-chan *pipelineJob, out chan<- *pipelineJob, dropped *atomic.Uint64, fn func(*pipelineJob)) {
+	var wg sync.WaitGroup
+	wg.Add(workers)
+	for i := 0; i < workers; i++ {
+		go func() {
+			defer wg.Done()
+			for job := range in {
+				if job.result.Err != nil {
+					out <- job
+					continue
+				}
+				switch {
+				case dropped == nil:
+				case p.coalescer == nil && !job.req.Deadline.IsZero() && !time.Now().Before(job.req.Deadline):
+					job.result.Err = ErrDeadlineExceeded
+					dropped.Add(1)
+				case p.gaps.blocked(job):
+					job.result.Err = ErrNonceGap
+					p.failedAfterGap.Add(1)
+				}
+				if job.result.Err == nil {
+					runPipelineStage(job, fn)
+				}
+				if job.result.Err != nil {
+					p.gaps.failed(job)
+				}
+				out <- job
+			}
+		}()
+	}
+	go func() {
+		wg.Wait()
+		close(out)
+	}()
+}
+
+func runPipelineStage(job *pipelineJob, fn func(*pipelineJob)) {
+	defer func() {
+		if r := recover(); r != nil {
+			job.result.Err = fmt.Errorf("panic: %v", r)
+		}
+	}()
+	fn(job)
+}
+
+// emit restores submission order. Pending is bounded by MaxInFlight through the slots semaphore.
+func (p *SignPipeline) emit() {
+	pending := make(map[uint64]*pipelineJob)
+	next := uint64(0)
+	for job := range p.encoded {
+		pending[job.seq] = job
+		for {
+			ready, ok := pending[next]
+			if !ok {
+				break
+			}
+			delete(pending, next)
+			next++
+
+			ready.result.Tag = ready.req.Tag
+			if p.archive != nil && ready.result.Err == nil {
+				if err := p.archive.Append(ready.result.TxInfo); err != nil && !errors.Is(err, archive.ErrUnsupportedTx) {
+					p.archiveFailed.Add(1)
+				}
+			}
+			p.results <- ready.result
+			<-p.slots
+		}
+	}
+	close(p.results)
+}
+
+// pipelineTxType returns the tx type of the supported request types
+func pipelineTxType(req any) (uint8, bool) {
+	switch req.(type) {
+	case *types.CreateOrderTxReq:
+		return txtypes.TxTypeL2CreateOrder, true
+	case *types.CreateGroupedOrdersTxReq:
+		return txtypes.TxTypeL2CreateGroupedOrders, true
+	case *types.ModifyOrderTxReq:
+		return txtypes.TxTypeL2ModifyOrder, true
+	case *types.CancelOrderTxReq:
+		return txtypes.TxTypeL2CancelOrder, true
+	case *types.CancelAllOrdersTxReq:
+		return txtypes.TxTypeL2CancelAllOrders, true
+	}
+	return 0, false
+}
+
+// convertPipelineJob builds & validates the tx of job, unless the coalescing dispatcher did already
+func convertPipelineJob(job *pipelineJob) {
+	ops := job.req.Ops
+	switch tx := job.req.Tx.(type) {
+	case *types.CreateOrderTxReq:
+		job.tx = types.ConvertCreateOrderTx(tx, ops)
+	case *types.CreateGroupedOrdersTxReq:
+		job.tx = types.ConvertCreateGroupedOrdersTx(tx, ops)
+	case *types.ModifyOrderTxReq:
+		job.tx = types.ConvertModifyOrderTx(tx, ops)
+	case *types.CancelOrderTxReq:
+		job.tx = types.ConvertCancelOrderTx(tx, ops)
+	case *types.CancelAllOrdersTxReq:
+		job.tx = types.ConvertCancelAllOrdersTx(tx, ops)
+	default:
+		job.result.Err = fmt.Errorf("unsupported pipeline request type %T", job.req.Tx)
+		return
+	}
+
+	if err := job.tx.Validate(); err != nil {
+		job.result.Err = err
+	}
+}
+
+func hashPipelineJob(job *pipelineJob) {
+	if job.tx == nil {
+		if convertPipelineJob(job); job.result.Err != nil {
+			return
+		}
+	}
+	msgHash, err := job.tx.Hash(job.req.Client.chainId)
+	if err != nil {
+		job.result.Err = err
+		return
+	}
+	job.msgHash = msgHash
+}
+
+func signPipelineJob(job *pipelineJob) {
+	if !job.admitted {
+		if err := job.req.Client.admit(job.tx.GetTxType()); err != nil {
+			job.result.Err = err
+			return
+		}
+	}
+	signature, err := job.req.Client.keyManager.Sign(job.msgHash, p2.NewPoseidon2())
+	if err != nil {
+		job.result.Err = err
+		return
+	}
+
+	signedHash := ethCommon.Bytes2Hex(job.msgHash)
+	switch tx := job.tx.(type) {
+	case *txtypes.L2CreateOrderTxInfo:
+		tx.Sig, tx.SignedHash = signature, signedHash
+	case *txtypes.L2CreateGroupedOrdersTxInfo:
+		tx.Sig, tx.SignedHash = signature, signedHash
+	case *txtypes.L2ModifyOrderTxInfo:
+		tx.Sig, tx.SignedHash = signature, signedHash
+	case *txtypes.L2CancelOrderTxInfo:
+		tx.Sig, tx.SignedHash = signature, signedHash
+	case *txtypes.L2CancelAllOrdersTxInfo:
+		tx.Sig, tx.SignedHash = signature, signedHash
+	}
+	job.result.TxInfo = job.tx
+}
+
+func encodePipelineJob(job *pipelineJob) {
+	txJSON, err := job.tx.GetTxInfo()
+	if err != nil {
+		job.result.Err = err
+		return
+	}
+	job.result.TxJSON = txJSON
+}
@@ -0,0 +1,251 @@
+package client
+
+import (
+	"fmt"
+	"sync"
+	"sync/atomic"
+	"time"
+
+	"github.com/elliottech/lighter-go/types"
+)
+
+// coalesceKey is an order of an (account, apiKey) pair, whichever client of the pair the request went through
+type coalesceKey struct {
+	client      clientKey
+	marketIndex int16
+	index       int64
+}
+
+type coalesceEntry struct {
+	req   PipelineRequest
+	key   coalesceKey
+	keyed bool
+	// dropped by a later CancelOrder, req is emitted with ErrCoalesced too
+	dropped bool
+	// tags of the requests req replaced, emitted with ErrCoalesced before req
+	superseded []any
+}
+
+func (e *coalesceEntry) isModify() bool {
+	_, ok := e.req.Tx.(*types.ModifyOrderTxReq)
+	return ok
+}
+
+// pipelineCoalescer is the queue in front of a coalescing SignPipeline. Requests stay coalescable until the
+// dispatcher takes them out, which it only does once the pipeline has a free slot.
+type pipelineCoalescer struct {
+	mu        sync.Mutex
+	cond      *sync.Cond
+	pending   []*coalesceEntry
+	byKey     map[coalesceKey]*coalesceEntry // latest pending entry of an order
+	maxQueued int
+	closed    bool
+
+	// only used by the dispatcher
+	firstNonce func(c *TxClient) (int64, error)
+	// next nonce per (account, apiKey), so a client replaced with RotateClient continues the sequence
+	nonces map[clientKey]int64
+
+	modifies atomic.Uint64
+	byCancel atomic.Uint64
+	cancels  atomic.Uint64
+}
+
+func newPipelineCoalescer(maxQueued int, firstNonce func(c *TxClient) (int64, error)) *pipelineCoalescer {
+	q := &pipelineCoalescer{
+		byKey:      make(map[coalesceKey]*coalesceEntry),
+		maxQueued:  maxQueued,
+		firstNonce: firstNonce,
+		nonces:     make(map[clientKey]int64),
+	}
+	q.cond = sync.NewCond(&q.mu)
+	if q.firstNonce == nil {
+		q.firstNonce = func(c *TxClient) (int64, error) {
+			if c.apiClient == nil {
+				return 0, fmt.Errorf("nonce can't be assigned: HTTPClient is nil, set PipelineConfig.NextNonce")
+			}
+			return c.apiClient.GetNextNonce(c.accountIndex, c.apiKeyIndex)
+		}
+	}
+	return q
+}
+
+// takeNonce returns the next nonce of key, fetching it for the first request of the key
+func (q *pipelineCoalescer) takeNonce(c *TxClient, key clientKey) (int64, error) {
+	nonce, ok := q.nonces[key]
+	if !ok {
+		var err error
+		if nonce, err = q.firstNonce(c); err != nil {
+			return 0, err
+		}
+	}
+	q.nonces[key] = nonce + 1
+	return nonce, nil
+}
+
+// releaseNonce hands back a nonce which won't be signed, if it's still the last one taken
+func (q *pipelineCoalescer) releaseNonce(key clientKey, nonce int64) {
+	if q.nonces[key] == nonce+1 {
+		q.nonces[key] = nonce
+	}
+}
+
+// rewindNonce restarts the sequence of key at an earlier nonce which won't be signed
+func (q *pipelineCoalescer) rewindNonce(key clientKey, nonce int64) {
+	if next, ok := q.nonces[key]; ok && nonce < next {
+		q.nonces[key] = nonce
+	}
+}
+
+func pipelineCoalesceKey(req PipelineRequest) (coalesceKey, bool) {
+	client := clientKey{accountIndex: req.Client.accountIndex, apiKeyIndex: req.Client.apiKeyIndex}
+	switch tx := req.Tx.(type) {
+	case *types.ModifyOrderTxReq:
+		return coalesceKey{client: client, marketIndex: tx.MarketIndex, index: tx.Index}, true
+	case *types.CancelOrderTxReq:
+		return coalesceKey{client: client, marketIndex: tx.MarketIndex, index: tx.Index}, true
+	}
+	return coalesceKey{}, false
+}
+
+func (q *pipelineCoalescer) submit(req PipelineRequest) error {
+	if req.Ops != nil && req.Ops.Nonce != nil && *req.Ops.Nonce != -1 {
+		return fmt.Errorf("nonces are assigned by coalescing pipelines, the request must not set one")
+	}
+	key, keyed := pipelineCoalesceKey(req)
+
+	q.mu.Lock()
+	defer q.mu.Unlock()
+	e := &coalesceEntry{req: req, key: key, keyed: keyed}
+	if prev, ok := q.byKey[key]; keyed && ok {
+		switch {
+		case e.isModify() && prev.isModify():
+			// keep the queue position, with the latest values
+			prev.superseded = append(prev.superseded, prev.req.Tag)
+			prev.req = req
+			q.modifies.Add(1)
+			return nil
+		case !e.isModify() && prev.isModify():
+			prev.dropped = true
+			q.byCancel.Add(uint64(1 + len(prev.superseded)))
+		case !e.isModify() && !prev.isModify():
+			prev.superseded = append(prev.superseded, req.Tag)
+			q.cancels.Add(1)
+			return nil
+		}
+		// a ModifyOrder after a pending CancelOrder is queued as is
+	}
+
+	for len(q.pending) >= q.maxQueued {
+		q.cond.Wait()
+	}
+	q.pending = append(q.pending, e)
+	if keyed {
+		q.byKey[key] = e
+	}
+	q.cond.Broadcast()
+	return nil
+}
+
+func (q *pipelineCoalescer) close() {
+	q.mu.Lock()
+	defer q.mu.Unlock()
+	q.closed = true
+	q.cond.Broadcast()
+}
+
+// next waits for a queued entry. It returns nil once the coalescer is closed and drained.
+func (q *pipelineCoalescer) next() *coalesceEntry {
+	q.mu.Lock()
+	defer q.mu.Unlock()
+	for len(q.pending) == 0 && !q.closed {
+		q.cond.Wait()
+	}
+	if len(q.pending) == 0 {
+		return nil
+	}
+	e := q.pending[0]
+	q.pending[0] = nil
+	q.pending = q.pending[1:]
+	if e.keyed && q.byKey[e.key] == e {
+		delete(q.byKey, e.key)
+	}
+	q.cond.Broadcast()
+	return e
+}
+
+// dispatch moves coalesced requests into the pipeline, assigning their nonce. It takes a slot before dequeuing,
+// so requests stay in the queue (and keep coalescing) while the pipeline is full.
+func (p *SignPipeline) dispatch() {
+	q := p.coalescer
+	for {
+		p.slots <- struct{}{}
+		e := q.next()
+		if e == nil {
+			<-p.slots
+			close(p.prepared)
+			return
+		}
+
+		for i, tag := range e.superseded {
+			if i > 0 {
+				p.slots <- struct{}{}
+			}
+			p.prepared <- &pipelineJob{seq: p.nextSeq, req: PipelineRequest{Tag: tag}, result: PipelineResult{Err: ErrCoalesced}}
+			p.nextSeq++
+		}
+		if len(e.superseded) > 0 {
+			p.slots <- struct{}{}
+		}
+
+		job := &pipelineJob{seq: p.nextSeq, req: e.req}
+		p.nextSeq++
+		switch {
+		case e.dropped:
+			job.result.Err = ErrCoalesced
+		case !e.req.Deadline.IsZero() && !time.Now().Before(e.req.Deadline):
+			job.result.Err = ErrDeadlineExceeded
+			p.droppedBeforeHash.Add(1)
+		default:
+			p.prepareCoalesced(job)
+		}
+		p.prepared <- job
+	}
+}
+
+// prepareCoalesced assigns the nonce of a request leaving the queue, then validates it and charges the rate limit.
+// These run here rather than in the stages, where a failure would leave a nonce gap: a request failing any of them
+// hands its nonce back. When a job failed in the stages, its nonce is assigned again, to the next request of its key.
+func (p *SignPipeline) prepareCoalesced(job *pipelineJob) {
+	q := p.coalescer
+	key := clientKey{accountIndex: job.req.Client.accountIndex, apiKeyIndex: job.req.Client.apiKeyIndex}
+	if nonce, ok := p.gaps.unsigned(key); ok {
+		q.rewindNonce(key, nonce)
+	}
+	nonce, err := q.takeNonce(job.req.Client, key)
+	if err != nil {
+		job.result.Err = err
+		return
+	}
+
+	var ops types.TransactOpts
+	if job.req.Ops != nil {
+		ops = *job.req.Ops
+	}
+	ops.Nonce = &nonce
+	job.req.Ops, err = job.req.Client.FullFillDefaultOps(&ops)
+	if err == nil {
+		runPipelineStage(job, convertPipelineJob)
+		err = job.result.Err
+	}
+	if err == nil {
+		err = job.req.Client.admit(job.tx.GetTxType())
+		job.admitted = true
+	}
+	if _, _, inSequence := pipelineJobNonce(job); err != nil || !inSequence {
+		job.result.Err = err
+		q.releaseNonce(key, nonce)
+		return
+	}
+	p.gaps.submitted(job)
+}
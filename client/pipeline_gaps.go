@@ -0,0 +1,111 @@
+package client
+
+import (
+	"sync"
+	"sync/atomic"
+)
+
+// pipelineGaps tracks, per API key, the first nonce which was resolved by Submit but not signed (dropped at its
+// deadline, rejected by the rate limit or invalid). The later jobs of the key would be rejected by the exchange,
+// so they fail fast with ErrNonceGap instead of being signed.
+//
+// Submit, or the dispatcher of a coalescing pipeline, numbers the nonce sequences of every key: a job whose nonce
+// isn't above the previous one of its key (the gap being filled, or the sequence rewound) starts a new sequence,
+// which a gap of an older one doesn't block.
+type pipelineGaps struct {
+	// only used by Submit, under submitMu, or by the dispatcher
+	sequences map[clientKey]nonceSequence
+
+	// set once a gap was recorded, so jobs don't take the lock before that
+	any   atomic.Bool
+	mu    sync.Mutex
+	first map[clientKey]nonceSequence
+}
+
+type nonceSequence struct {
+	epoch uint64
+	nonce int64
+}
+
+func newPipelineGaps() *pipelineGaps {
+	return &pipelineGaps{
+		sequences: make(map[clientKey]nonceSequence),
+		first:     make(map[clientKey]nonceSequence),
+	}
+}
+
+// pipelineJobNonce returns the key & nonce of a job, false if it doesn't take a place in the nonce sequence
+func pipelineJobNonce(job *pipelineJob) (clientKey, int64, bool) {
+	ops := job.req.Ops
+	if ops == nil || ops.Nonce == nil {
+		return clientKey{}, 0, false
+	}
+	if attrs := ops.TxAttributes; attrs != nil && attrs.SkipNonce != nil && *attrs.SkipNonce != 0 {
+		return clientKey{}, 0, false
+	}
+	return clientKey{accountIndex: job.req.Client.accountIndex, apiKeyIndex: job.req.Client.apiKeyIndex}, *ops.Nonce, true
+}
+
+// submitted assigns the nonce sequence of job
+func (g *pipelineGaps) submitted(job *pipelineJob) {
+	key, nonce, ok := pipelineJobNonce(job)
+	if !ok {
+		return
+	}
+	seq, found := g.sequences[key]
+	if found && nonce <= seq.nonce {
+		seq.epoch++
+	}
+	seq.nonce = nonce
+	g.sequences[key] = seq
+	job.epoch = seq.epoch
+}
+
+// failed records that the nonce of job won't be used
+func (g *pipelineGaps) failed(job *pipelineJob) {
+	key, nonce, ok := pipelineJobNonce(job)
+	if !ok {
+		return
+	}
+	g.mu.Lock()
+	defer g.mu.Unlock()
+	first, found := g.first[key]
+	if !found || job.epoch > first.epoch || (job.epoch == first.epoch && nonce < first.nonce) {
+		g.first[key] = nonceSequence{epoch: job.epoch, nonce: nonce}
+		g.any.Store(true)
+	}
+}
+
+// unsigned returns the first nonce of the current sequence of key which won't be used, if any.
+// The dispatcher of a coalescing pipeline assigns it again, which starts a new sequence.
+func (g *pipelineGaps) unsigned(key clientKey) (int64, bool) {
+	if !g.any.Load() {
+		return 0, false
+	}
+	seq, ok := g.sequences[key]
+	if !ok {
+		return 0, false
+	}
+	g.mu.Lock()
+	defer g.mu.Unlock()
+	first, found := g.first[key]
+	if !found || first.epoch != seq.epoch {
+		return 0, false
+	}
+	return first.nonce, true
+}
+
+// blocked reports whether an earlier nonce of the sequence of job won't be used
+func (g *pipelineGaps) blocked(job *pipelineJob) bool {
+	if !g.any.Load() {
+		return false
+	}
+	key, nonce, ok := pipelineJobNonce(job)
+	if !ok {
+		return false
+	}
+	g.mu.Lock()
+	defer g.mu.Unlock()
+	first, found := g.first[key]
+	return found && first.epoch == job.epoch && nonce > first.nonce
+}
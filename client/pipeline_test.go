@@ -0,0 +1,474 @@
+package client
+
+import (
+	"bytes"
+	"errors"
+	"fmt"
+	"hash"
+	"sync/atomic"
+	"testing"
+	"time"
+
+	"github.com/elliottech/lighter-go/archive"
+	"github.com/elliottech/lighter-go/signer"
+	"github.com/elliottech/lighter-go/types"
+	"github.com/elliottech/lighter-go/types/txtypes"
+)
+
+func newPipelineTestClients(tb testing.TB, n int) []*TxClient {
+	tb.Helper()
+	clients := make([]*TxClient, n)
+	for i := range clients {
+		priv, _, err := GenerateAPIKey()
+		if err != nil {
+			tb.Fatalf("GenerateAPIKey error: %v", err)
+		}
+		clients[i], err = NewTxClient(nil, priv, testAccountIndex, uint8(i), testChainID)
+		if err != nil {
+			tb.Fatalf("NewTxClient failed: %v", err)
+		}
+	}
+	return clients
+}
+
+func pipelineTestOps(nonce int64, expiredAt int64) *types.TransactOpts {
+	return &types.TransactOpts{Nonce: &nonce, ExpiredAt: expiredAt}
+}
+
+func pipelineTestOrder(i int) *types.CreateOrderTxReq {
+	return &types.CreateOrderTxReq{
+		MarketIndex:      0,
+		ClientOrderIndex: int64(i + 1),
+		BaseAmount:       1000,
+		Price:            50000,
+		TimeInForce:      1,
+		OrderExpiry:      time.Now().Add(time.Hour).UnixMilli(),
+	}
+}
+
+func TestSignPipelineOrderAndHashes(t *testing.T) {
+	clients := newPipelineTestClients(t, 3)
+	expiredAt := time.Now().Add(time.Minute).UnixMilli()
+	const perClient = 50
+
+	p := NewSignPipeline(PipelineConfig{Workers: 4, MaxInFlight: 16})
+	expected := make([]string, 0, perClient*len(clients))
+
+	go func() {
+		defer p.Close()
+		for i := 0; i < perClient; i++ {
+			for _, c := range clients {
+				req := &types.CancelOrderTxReq{MarketIndex: 0, Index: int64(i + 1)}
+				if err := p.Submit(PipelineRequest{Client: c, Tx: req, Ops: pipelineTestOps(int64(i), expiredAt)}); err != nil {
+					t.Errorf("Submit failed: %v", err)
+					return
+				}
+			}
+		}
+	}()
+
+	for i := 0; i < perClient; i++ {
+		for _, c := range clients {
+			req := &types.CancelOrderTxReq{MarketIndex: 0, Index: int64(i + 1)}
+			tx, err := c.GetCancelOrderTransaction(req, pipelineTestOps(int64(i), expiredAt))
+			if err != nil {
+				t.Fatalf("GetCancelOrderTransaction failed: %v", err)
+			}
+			expected = append(expected, tx.GetTxHash())
+		}
+	}
+
+	lastNonce := make(map[uint8]int64)
+	i := 0
+	for res := range p.Results() {
+		if res.Err != nil {
+			t.Fatalf("result %d failed: %v", i, res.Err)
+		}
+		if res.TxInfo.GetTxHash() != expected[i] {
+			t.Errorf("result %d: hash %s, want %s", i, res.TxInfo.GetTxHash(), expected[i])
+		}
+		if res.TxJSON == "" {
+			t.Errorf("result %d: empty TxJSON", i)
+		}
+
+		// per-key nonce order
+		apiKey := clients[i%len(clients)].GetApiKeyIndex()
+		nonce := int64(i / len(clients))
+		if prev, ok := lastNonce[apiKey]; ok && prev+1 != nonce {
+			t.Errorf("result %d: apiKey %d nonce %d follows %d", i, apiKey, nonce, prev)
+		}
+		lastNonce[apiKey] = nonce
+		i++
+	}
+	if i != len(expected) {
+		t.Fatalf("got %d results, want %d", i, len(expected))
+	}
+}
+
+func TestSignPipelineUnsupportedRequest(t *testing.T) {
+	clients := newPipelineTestClients(t, 1)
+	p := NewSignPipeline(PipelineConfig{})
+	if err := p.Submit(PipelineRequest{Client: clients[0], Tx: &types.WithdrawTxReq{}, Ops: pipelineTestOps(0, 0), Tag: 7}); err != nil {
+		t.Fatalf("Submit failed: %v", err)
+	}
+	p.Close()
+
+	res := <-p.Results()
+	if res.Err == nil {
+		t.Error("expected an error for an unsupported request type")
+	}
+	if res.Tag != 7 {
+		t.Errorf("Tag = %v, want 7", res.Tag)
+	}
+	if _, ok := <-p.Results(); ok {
+		t.Error("results channel should be closed")
+	}
+}
+
+func TestSignPipelineDeadline(t *testing.T) {
+	// the last request uses another key, so it's not behind the nonce gap of the expired one
+	clients := newPipelineTestClients(t, 2)
+	p := NewSignPipeline(PipelineConfig{Workers: 1})
+	deadlines := []time.Time{{}, time.Now().Add(-time.Millisecond), time.Now().Add(time.Minute)}
+	for i, deadline := range deadlines {
+		req := PipelineRequest{Client: clients[i/2], Tx: pipelineTestOrder(i), Ops: pipelineTestOps(int64(i), 0), Deadline: deadline, Tag: i}
+		if err := p.Submit(req); err != nil {
+			t.Fatalf("Submit failed: %v", err)
+		}
+	}
+	p.Close()
+
+	for res := range p.Results() {
+		expired := res.Tag == 1
+		if expired != errors.Is(res.Err, ErrDeadlineExceeded) || (!expired && res.Err != nil) {
+			t.Errorf("result %v: err = %v", res.Tag, res.Err)
+		}
+		if expired && res.TxInfo != nil {
+			t.Errorf("result %v: expired request was signed", res.Tag)
+		}
+	}
+	if s := p.Stats(); s.DroppedBeforeHash != 1 || s.DroppedBeforeSign != 0 {
+		t.Errorf("stats = %+v", s)
+	}
+}
+
+func TestSignPipelineNonceGap(t *testing.T) {
+	clients := newPipelineTestClients(t, 2)
+	p := NewSignPipeline(PipelineConfig{Workers: 1})
+	submit := func(c *TxClient, nonce int64, deadline time.Time, tag string) {
+		req := PipelineRequest{Client: c, Tx: pipelineTestOrder(int(nonce)), Ops: pipelineTestOps(nonce, 0), Deadline: deadline, Tag: tag}
+		if err := p.Submit(req); err != nil {
+			t.Fatalf("Submit %s failed: %v", tag, err)
+		}
+	}
+	submit(clients[0], 0, time.Time{}, "key 0 nonce 0")
+	submit(clients[0], 1, time.Now().Add(-time.Millisecond), "key 0 nonce 1 expired")
+	submit(clients[0], 2, time.Time{}, "key 0 nonce 2")
+	submit(clients[1], 5, time.Time{}, "key 1 nonce 5")
+	submit(clients[0], 1, time.Time{}, "key 0 nonce 1 again")
+	submit(clients[0], 2, time.Time{}, "key 0 nonce 2 again")
+	p.Close()
+
+	want := map[string]error{"key 0 nonce 1 expired": ErrDeadlineExceeded, "key 0 nonce 2": ErrNonceGap}
+	for res := range p.Results() {
+		if !errors.Is(res.Err, want[res.Tag.(string)]) {
+			t.Errorf("%v: err = %v, want %v", res.Tag, res.Err, want[res.Tag.(string)])
+		}
+	}
+	if s := p.Stats(); s.DroppedBeforeHash != 1 || s.FailedAfterGap != 1 {
+		t.Errorf("stats = %+v", s)
+	}
+}
+
+func TestSignPipelineCoalesce(t *testing.T) {
+	c := newPipelineTestClients(t, 1)[0]
+	release := make(chan struct{})
+	nonce := int64(0)
+	p := NewSignPipeline(PipelineConfig{Workers: 2, MaxInFlight: 16, Coalesce: true, NextNonce: func(*TxClient) (int64, error) {
+		if nonce == 0 {
+			<-release // hold the queue until every request was submitted
+		}
+		nonce++
+		return nonce - 1, nil
+	}})
+
+	modify := func(index int64, price uint32) *types.ModifyOrderTxReq {
+		return &types.ModifyOrderTxReq{MarketIndex: 0, Index: index, BaseAmount: 1000, Price: price}
+	}
+	cancel := func(index int64) *types.CancelOrderTxReq {
+		return &types.CancelOrderTxReq{MarketIndex: 0, Index: index}
+	}
+	requests := []struct {
+		tag string
+		tx  any
+	}{
+		{"create", pipelineTestOrder(0)},
+		{"modify 1a", modify(1, 100)}, {"modify 1b", modify(1, 101)}, {"modify 1c", modify(1, 102)},
+		{"cancel 2", cancel(2)}, {"modify 2", modify(2, 100)},
+		{"modify 4", modify(4, 100)},
+		{"cancel 3a", cancel(3)}, {"cancel 3b", cancel(3)},
+		{"cancel 4", cancel(4)},
+	}
+	for _, r := range requests {
+		if err := p.Submit(PipelineRequest{Client: c, Tx: r.tx, Tag: r.tag}); err != nil {
+			t.Fatalf("Submit %s failed: %v", r.tag, err)
+		}
+	}
+	if err := p.Submit(PipelineRequest{Client: c, Tx: cancel(5), Ops: pipelineTestOps(3, 0)}); err == nil {
+		t.Error("a request with a nonce should be refused")
+	}
+	close(release)
+	p.Close()
+
+	expected := []struct {
+		tag       string
+		coalesced bool
+	}{
+		{"create", false},
+		{"modify 1a", true}, {"modify 1b", true}, {"modify 1c", false},
+		{"cancel 2", false}, {"modify 2", false},
+		{"modify 4", true},
+		{"cancel 3b", true}, {"cancel 3a", false},
+		{"cancel 4", false},
+	}
+	i, nextNonce := 0, int64(0)
+	for res := range p.Results() {
+		if i >= len(expected) {
+			t.Fatalf("unexpected result %v", res.Tag)
+		}
+		want := expected[i]
+		i++
+		if res.Tag != want.tag || want.coalesced != errors.Is(res.Err, ErrCoalesced) || (!want.coalesced && res.Err != nil) {
+			t.Errorf("result %d: tag %v err %v, want %+v", i, res.Tag, res.Err, want)
+			continue
+		}
+		if want.coalesced {
+			continue
+		}
+		var got int64
+		switch tx := res.TxInfo.(type) {
+		case *txtypes.L2CreateOrderTxInfo:
+			got = tx.Nonce
+		case *txtypes.L2ModifyOrderTxInfo:
+			got = tx.Nonce
+		case *txtypes.L2CancelOrderTxInfo:
+			got = tx.Nonce
+		}
+		if got != nextNonce {
+			t.Errorf("%s: nonce %d, want %d", want.tag, got, nextNonce)
+		}
+		nextNonce++
+		if want.tag == "modify 1c" && res.TxInfo.(*txtypes.L2ModifyOrderTxInfo).Price != 102 {
+			t.Errorf("modify 1c: price %d, want the latest", res.TxInfo.(*txtypes.L2ModifyOrderTxInfo).Price)
+		}
+	}
+	if i != len(expected) {
+		t.Fatalf("got %d results, want %d", i, len(expected))
+	}
+	if s := p.Stats(); s.CoalescedModifies != 2 || s.CoalescedByCancel != 1 || s.CoalescedCancels != 1 {
+		t.Errorf("stats = %+v", s)
+	}
+}
+
+func TestSignPipelineCoalesceDeadlineAfterDispatch(t *testing.T) {
+	c := newPipelineTestClients(t, 1)[0]
+	deadline := time.Now().Add(50 * time.Millisecond)
+	p := NewSignPipeline(PipelineConfig{Workers: 1, Coalesce: true, NextNonce: func(*TxClient) (int64, error) {
+		// the deadline passes once the request left the queue with its nonce
+		time.Sleep(time.Until(deadline) + 20*time.Millisecond)
+		return 7, nil
+	}})
+	if err := p.Submit(PipelineRequest{Client: c, Tx: pipelineTestOrder(0), Deadline: deadline}); err != nil {
+		t.Fatalf("Submit failed: %v", err)
+	}
+	p.Close()
+
+	res := <-p.Results()
+	if res.Err != nil || res.TxInfo.(*txtypes.L2CreateOrderTxInfo).Nonce != 7 {
+		t.Errorf("a request holding a nonce must be signed, got %+v", res)
+	}
+	if s := p.Stats(); s.DroppedBeforeHash != 0 || s.DroppedBeforeSign != 0 {
+		t.Errorf("stats = %+v", s)
+	}
+}
+
+func TestSignPipelineArchive(t *testing.T) {
+	c := newPipelineTestClients(t, 1)[0]
+	var buf bytes.Buffer
+	w, err := archive.NewWriter(&buf, archive.WriterConfig{BlockRows: 2})
+	if err != nil {
+		t.Fatal(err)
+	}
+	p := NewSignPipeline(PipelineConfig{Workers: 2, Archive: w})
+
+	bad := pipelineTestOrder(3)
+	bad.Price = 0
+	for i, tx := range []*types.CreateOrderTxReq{pipelineTestOrder(0), pipelineTestOrder(1), pipelineTestOrder(2), bad} {
+		if err := p.Submit(PipelineRequest{Client: c, Tx: tx, Ops: pipelineTestOps(int64(i), 0)}); err != nil {
+			t.Fatal(err)
+		}
+	}
+	p.Close()
+	var hashes []string
+	for res := range p.Results() {
+		if res.Err == nil {
+			hashes = append(hashes, res.TxInfo.GetTxHash())
+		}
+	}
+	if err := w.Close(); err != nil {
+		t.Fatal(err)
+	}
+
+	// only the signed txs are archived, in emit order
+	r, err := archive.NewReader(buf.Bytes())
+	if err != nil {
+		t.Fatal(err)
+	}
+	var archived []string
+	if err := r.Scan(nil, func(row *archive.Row) bool {
+		tx, err := row.TxInfo()
+		if err != nil {
+			t.Fatal(err)
+		}
+		archived = append(archived, tx.GetTxHash())
+		return true
+	}); err != nil {
+		t.Fatal(err)
+	}
+	if len(hashes) != 3 || fmt.Sprint(archived) != fmt.Sprint(hashes) || p.Stats().ArchiveFailed != 0 {
+		t.Errorf("archived %v, signed %v, stats %+v", archived, hashes, p.Stats())
+	}
+}
+
+func TestSignPipelineCoalesceRotatedClient(t *testing.T) {
+	c := newPipelineTestClients(t, 1)[0]
+	priv, _, err := GenerateAPIKey()
+	if err != nil {
+		t.Fatal(err)
+	}
+	rotated, err := NewTxClient(nil, priv, c.accountIndex, c.apiKeyIndex, testChainID)
+	if err != nil {
+		t.Fatal(err)
+	}
+	release := make(chan struct{})
+	p := NewSignPipeline(PipelineConfig{Workers: 1, Coalesce: true, NextNonce: func(*TxClient) (int64, error) {
+		<-release
+		return 0, nil
+	}})
+
+	// the first request holds the dispatcher, the modifies of the same order coalesce across the pair's clients
+	reqs := []PipelineRequest{
+		{Client: c, Tx: pipelineTestOrder(0), Tag: "create"},
+		{Client: c, Tx: &types.ModifyOrderTxReq{Index: 1, BaseAmount: 1000, Price: 100}, Tag: "old"},
+		{Client: rotated, Tx: &types.ModifyOrderTxReq{Index: 1, BaseAmount: 1000, Price: 101}, Tag: "new"},
+	}
+	for _, req := range reqs {
+		if err := p.Submit(req); err != nil {
+			t.Fatal(err)
+		}
+	}
+	close(release)
+	p.Close()
+
+	var tags []any
+	for res := range p.Results() {
+		if res.Tag == "old" != errors.Is(res.Err, ErrCoalesced) || (res.Tag != "old" && res.Err != nil) {
+			t.Errorf("%v: %v", res.Tag, res.Err)
+		}
+		tags = append(tags, res.Tag)
+	}
+	if fmt.Sprint(tags) != "[create old new]" || p.Stats().CoalescedModifies != 1 {
+		t.Errorf("results %v, stats %+v", tags, p.Stats())
+	}
+}
+
+// failingSigner fails the next Sign once fail is set
+type failingSigner struct {
+	signer.KeyManager
+	fail atomic.Bool
+}
+
+func (s *failingSigner) Sign(message []byte, hFunc hash.Hash) ([]byte, error) {
+	if s.fail.CompareAndSwap(true, false) {
+		return nil, errors.New("signing failed")
+	}
+	return s.KeyManager.Sign(message, hFunc)
+}
+
+func TestSignPipelineCoalesceNoGap(t *testing.T) {
+	c := newPipelineTestClients(t, 1)[0]
+	keys := &failingSigner{KeyManager: c.keyManager}
+	c.keyManager = keys
+	p := NewSignPipeline(PipelineConfig{Workers: 2, Coalesce: true, NextNonce: func(*TxClient) (int64, error) { return 10, nil }})
+	defer p.Close()
+
+	sign := func(tx any) (int64, error) {
+		if err := p.Submit(PipelineRequest{Client: c, Tx: tx}); err != nil {
+			t.Fatalf("Submit failed: %v", err)
+		}
+		res := <-p.Results()
+		if res.Err != nil {
+			return 0, res.Err
+		}
+		return res.TxInfo.(*txtypes.L2CreateOrderTxInfo).Nonce, nil
+	}
+
+	bad := pipelineTestOrder(1)
+	bad.Price = 0
+	keys.fail.Store(true)
+	for i, step := range []struct {
+		tx      any
+		wantErr bool
+		nonce   int64
+	}{
+		{pipelineTestOrder(0), true, 0}, // fails at signing, after taking nonce 10
+		{pipelineTestOrder(1), false, 10},
+		{bad, true, 0}, // fails validation, before signing
+		{&types.WithdrawTxReq{}, true, 0},
+		{pipelineTestOrder(2), false, 11},
+	} {
+		nonce, err := sign(step.tx)
+		if (err != nil) != step.wantErr || nonce != step.nonce {
+			t.Errorf("request %d: nonce %d, err %v, want %+v", i, nonce, err, step)
+		}
+	}
+}
+
+func BenchmarkSignLoop(b *testing.B) {
+	c := newPipelineTestClients(b, 1)[0]
+	b.ReportAllocs()
+	b.ResetTimer()
+	for i := 0; i < b.N; i++ {
+		tx, err := c.GetCreateOrderTransaction(pipelineTestOrder(i), pipelineTestOps(int64(i), 0))
+		if err != nil {
+			b.Fatal(err)
+		}
+		if _, err := tx.GetTxInfo(); err != nil {
+			b.Fatal(err)
+		}
+	}
+}
+
+func BenchmarkSignPipeline(b *testing.B) {
+	c := newPipelineTestClients(b, 1)[0]
+	p := NewSignPipeline(PipelineConfig{})
+	done := make(chan struct{})
+	go func() {
+		for res := range p.Results() {
+			if res.Err != nil {
+				b.Error(res.Err)
+			}
+		}
+		close(done)
+	}()
+
+	b.ReportAllocs()
+	b.ResetTimer()
+	for i := 0; i < b.N; i++ {
+		if err := p.Submit(PipelineRequest{Client: c, Tx: pipelineTestOrder(i), Ops: pipelineTestOps(int64(i), 0)}); err != nil {
+			b.Fatal(err)
+		}
+	}
+	p.Close()
+	<-done
+}
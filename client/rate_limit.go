@@ -0,0 +1,233 @@
+package client
+
+import (
+	"errors"
+	"hash"
+	"sync"
+	"sync/atomic"
+	"time"
+
+	"github.com/elliottech/lighter-go/signer"
+	"github.com/elliottech/lighter-go/types"
+	"github.com/elliottech/lighter-go/types/txtypes"
+)
+
+var ErrRateLimited = errors.New("rate limit exceeded, transaction was not signed")
+
+// RateLimit is a token bucket: Capacity tokens at most, refilled continuously at RefillPerSecond.
+type RateLimit struct {
+	Capacity        float64
+	RefillPerSecond float64
+}
+
+// RateLimitCounters are cumulative since the limit was set.
+// Admitted transactions were within budget, OverLimit ones were over budget but still signed
+// (RejectBeforeSigning disabled) and Rejected ones were refused before signing.
+type RateLimitCounters struct {
+	Admitted  uint64
+	OverLimit uint64
+	Rejected  uint64
+	// Tokens currently left in the (account, apiKey) bucket
+	Tokens float64
+}
+
+type tokenBucket struct {
+	limit  RateLimit
+	tokens float64
+	last   time.Time
+}
+
+func newTokenBucket(limit RateLimit, now time.Time) *tokenBucket {
+	return &tokenBucket{limit: limit, tokens: limit.Capacity, last: now}
+}
+
+func (b *tokenBucket) refill(now time.Time) {
+	if elapsed := now.Sub(b.last).Seconds(); elapsed > 0 {
+		b.tokens += elapsed * b.limit.RefillPerSecond
+		if b.tokens > b.limit.Capacity {
+			b.tokens = b.limit.Capacity
+		}
+		b.last = now
+	}
+}
+
+// rateLimits holds the limiter of an (account, apiKey) pair, nil unless SetRateLimit or SetTxTypeRateLimit was called.
+// The registry slot of the pair owns it, so the clients registered for the pair (rotated keys, clients created again)
+// share the same limits.
+type rateLimits struct {
+	atomic.Pointer[rateLimiter]
+}
+
+// rateLimiter tracks the weighted budget of one (account, apiKey) pair, plus optional per tx type budgets.
+// Tx types without an explicit weight cost 1 token.
+type rateLimiter struct {
+	mu                  sync.Mutex
+	key                 *tokenBucket
+	weights             map[uint8]float64
+	perType             map[uint8]*tokenBucket
+	rejectBeforeSigning bool
+	counters            RateLimitCounters
+}
+
+func (l *rateLimiter) weight(txType uint8) float64 {
+	if w, ok := l.weights[txType]; ok {
+		return w
+	}
+	return 1
+}
+
+// canSendLocked refills the buckets and reports whether txType fits in the budget
+func (l *rateLimiter) canSendLocked(txType uint8, now time.Time) bool {
+	ok := true
+	if l.key != nil {
+		l.key.refill(now)
+		ok = l.key.tokens >= l.weight(txType)
+	}
+	if b := l.perType[txType]; b != nil {
+		b.refill(now)
+		ok = ok && b.tokens >= 1
+	}
+	return ok
+}
+
+func (l *rateLimiter) admit(txType uint8) error {
+	l.mu.Lock()
+	defer l.mu.Unlock()
+
+	if !l.canSendLocked(txType, time.Now()) {
+		if l.rejectBeforeSigning {
+			l.counters.Rejected++
+			return ErrRateLimited
+		}
+		l.counters.OverLimit++
+	} else {
+		l.counters.Admitted++
+	}
+
+	// buckets can go negative when over limit, so sustained overuse is still paid back
+	if l.key != nil {
+		l.key.tokens -= l.weight(txType)
+	}
+	if b := l.perType[txType]; b != nil {
+		b.tokens--
+	}
+	return nil
+}
+
+func (c *TxClient) limiter() *rateLimiter {
+	if l := c.limits.Load(); l != nil {
+		return l
+	}
+	c.limits.CompareAndSwap(nil, &rateLimiter{
+		weights: make(map[uint8]float64),
+		perType: make(map[uint8]*tokenBucket),
+	})
+	return c.limits.Load()
+}
+
+// SetRateLimit sets the weighted budget shared by all transactions of this (account, apiKey) pair.
+// With rejectBeforeSigning, transactions over budget fail with ErrRateLimited before they're signed,
+// otherwise they're signed and only counted as OverLimit.
+func (c *TxClient) SetRateLimit(limit RateLimit, rejectBeforeSigning bool) {
+	l := c.limiter()
+	l.mu.Lock()
+	defer l.mu.Unlock()
+	l.key = newTokenBucket(limit, time.Now())
+	l.rejectBeforeSigning = rejectBeforeSigning
+	l.counters = RateLimitCounters{}
+}
+
+// SetTxTypeRateLimit sets how many tokens txType costs against the (account, apiKey) budget and,
+// if limit.Capacity is positive, a separate budget for txType alone.
+func (c *TxClient) SetTxTypeRateLimit(txType uint8, weight float64, limit RateLimit) {
+	l := c.limiter()
+	l.mu.Lock()
+	defer l.mu.Unlock()
+	l.weights[txType] = weight
+	if limit.Capacity > 0 {
+		l.perType[txType] = newTokenBucket(limit, time.Now())
+	} else {
+		delete(l.perType, txType)
+	}
+}
+
+// ClearRateLimit removes all the limits of this client.
+func (c *TxClient) ClearRateLimit() {
+	c.limits.Store(nil)
+}
+
+// CanSend reports whether a transaction of txType fits in the current budget, without consuming it.
+func (c *TxClient) CanSend(txType uint8) bool {
+	l := c.limits.Load()
+	if l == nil {
+		return true
+	}
+	l.mu.Lock()
+	defer l.mu.Unlock()
+	return l.canSendLocked(txType, time.Now())
+}
+
+func (c *TxClient) RateLimitCounters() RateLimitCounters {
+	l := c.limits.Load()
+	if l == nil {
+		return RateLimitCounters{}
+	}
+	l.mu.Lock()
+	defer l.mu.Unlock()
+	counters := l.counters
+	if l.key != nil {
+		l.key.refill(time.Now())
+		counters.Tokens = l.key.tokens
+	}
+	return counters
+}
+
+// admit is called right before a transaction is signed, once it was validated and its nonce resolved,
+// so invalid transactions don't consume the budget. It's a single atomic load if no limit was set.
+func (c *TxClient) admit(txType uint8) error {
+	l := c.limits.Load()
+	if l == nil {
+		return nil
+	}
+	return l.admit(txType)
+}
+
+// admittingSigner admits the transaction when the types.Construct* functions sign it, after validating & hashing
+type admittingSigner struct {
+	signer.Signer
+	c      *TxClient
+	txType uint8
+}
+
+func (s admittingSigner) Sign(message []byte, hFunc hash.Hash) ([]byte, error) {
+	if err := s.c.admit(s.txType); err != nil {
+		return nil, err
+	}
+	return s.Signer.Sign(message, hFunc)
+}
+
+// signUnmetered signs an order-flow request (see PipelineRequest.Tx) without charging the rate limit,
+// for the library's own transactions (warm-up, nonce gap fillers) which must neither be refused nor eat the budget
+func (c *TxClient) signUnmetered(req any, ops *types.TransactOpts) (txtypes.TxInfo, error) {
+	ops, err := c.FullFillDefaultOps(ops)
+	if err != nil {
+		return nil, err
+	}
+	job := &pipelineJob{req: PipelineRequest{Client: c, Tx: req, Ops: ops}, admitted: true}
+	runPipelineStage(job, hashPipelineJob)
+	if job.result.Err == nil {
+		runPipelineStage(job, signPipelineJob)
+	}
+	if job.result.Err != nil {
+		return nil, job.result.Err
+	}
+	return job.tx, nil
+}
+
+// signerFor returns the signer of the Get*Transaction methods: the key, charging the rate limit if one was set
+func (c *TxClient) signerFor(txType uint8) signer.Signer {
+	if c.limits.Load() == nil {
+		return c.keyManager
+	}
+	return admittingSigner{Signer: c.keyManager, c: c, txType: txType}
+}
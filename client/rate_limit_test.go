@@ -0,0 +1,101 @@
+package client
+
+import (
+	"errors"
+	"testing"
+	"time"
+
+	"github.com/elliottech/lighter-go/types"
+	"github.com/elliottech/lighter-go/types/txtypes"
+)
+
+func TestRateLimitWeights(t *testing.T) {
+	c := newPipelineTestClients(t, 1)[0]
+	expiredAt := time.Now().Add(time.Minute).UnixMilli()
+	cancel := func(nonce int64) error {
+		_, err := c.GetCancelOrderTransaction(&types.CancelOrderTxReq{MarketIndex: 0, Index: 1}, pipelineTestOps(nonce, expiredAt))
+		return err
+	}
+
+	if !c.CanSend(txtypes.TxTypeL2CancelOrder) {
+		t.Fatal("a client without limits can always send")
+	}
+
+	c.SetRateLimit(RateLimit{Capacity: 5}, true)
+	c.SetTxTypeRateLimit(txtypes.TxTypeL2CancelOrder, 2, RateLimit{})
+
+	// 5 tokens at a weight of 2: two cancels fit, the third doesn't
+	for i := int64(0); i < 2; i++ {
+		if err := cancel(i); err != nil {
+			t.Fatalf("cancel %d failed: %v", i, err)
+		}
+	}
+	if c.CanSend(txtypes.TxTypeL2CancelOrder) {
+		t.Error("CanSend should report the cancel over budget")
+	}
+	if !c.CanSend(txtypes.TxTypeL2CreateOrder) {
+		t.Error("CanSend should report an unweighted tx within budget")
+	}
+	if err := cancel(2); !errors.Is(err, ErrRateLimited) {
+		t.Errorf("err = %v, want ErrRateLimited", err)
+	}
+
+	counters := c.RateLimitCounters()
+	if counters.Admitted != 2 || counters.Rejected != 1 || counters.OverLimit != 0 || counters.Tokens != 1 {
+		t.Errorf("counters = %+v", counters)
+	}
+}
+
+func TestRateLimitInvalidTxNotCharged(t *testing.T) {
+	c := newPipelineTestClients(t, 1)[0]
+	c.SetRateLimit(RateLimit{Capacity: 1}, true)
+
+	invalid := pipelineTestOrder(0)
+	invalid.Price = 0
+	if _, err := c.GetCreateOrderTransaction(invalid, pipelineTestOps(0, 0)); err == nil || errors.Is(err, ErrRateLimited) {
+		t.Fatalf("err = %v, want a validation error", err)
+	}
+	if _, err := c.GetCreateOrderTransaction(pipelineTestOrder(0), pipelineTestOps(0, 0)); err != nil {
+		t.Fatalf("the invalid tx consumed the budget: %v", err)
+	}
+	if counters := c.RateLimitCounters(); counters.Admitted != 1 || counters.Rejected != 0 {
+		t.Errorf("counters = %+v", counters)
+	}
+}
+
+func TestRateLimitTxTypeBucket(t *testing.T) {
+	c := newPipelineTestClients(t, 1)[0]
+	expiredAt := time.Now().Add(time.Minute).UnixMilli()
+
+	// sign anyway: over budget transactions are only counted
+	c.SetRateLimit(RateLimit{Capacity: 100}, false)
+	c.SetTxTypeRateLimit(txtypes.TxTypeL2CreateOrder, 1, RateLimit{Capacity: 1})
+	for i := 0; i < 3; i++ {
+		if _, err := c.GetCreateOrderTransaction(pipelineTestOrder(i), pipelineTestOps(int64(i), expiredAt)); err != nil {
+			t.Fatalf("create %d failed: %v", i, err)
+		}
+	}
+
+	counters := c.RateLimitCounters()
+	if counters.Admitted != 1 || counters.OverLimit != 2 || counters.Rejected != 0 {
+		t.Errorf("counters = %+v", counters)
+	}
+
+	c.ClearRateLimit()
+	if !c.CanSend(txtypes.TxTypeL2CreateOrder) {
+		t.Error("CanSend should be true after ClearRateLimit")
+	}
+}
+
+func BenchmarkRateLimitAdmit(b *testing.B) {
+	c := newPipelineTestClients(b, 1)[0]
+	c.SetRateLimit(RateLimit{Capacity: 1e12, RefillPerSecond: 1e12}, true)
+	c.SetTxTypeRateLimit(txtypes.TxTypeL2CancelOrder, 2, RateLimit{})
+	b.ReportAllocs()
+	b.ResetTimer()
+	for i := 0; i < b.N; i++ {
+		if err := c.admit(txtypes.TxTypeL2CancelOrder); err != nil {
+			b.Fatal(err)
+		}
+	}
+}
@@ -0,0 +1,207 @@
+package client
+
+import (
+	"errors"
+	"runtime"
+	"sync/atomic"
+	"time"
+
+	"github.com/elliottech/lighter-go/types/txtypes"
+)
+
+var (
+	ErrNonceReleased      = errors.New("nonce was already released or skipped")
+	ErrNonceBuffered      = errors.New("a tx with this nonce is already buffered")
+	ErrReorderWindowFull  = errors.New("nonce is too far ahead of the next nonce to release")
+	errReorderEmptyInsert = errors.New("tx is nil")
+)
+
+type ReorderConfig struct {
+	// FirstNonce is the first nonce released
+	FirstNonce int64
+	// Capacity is the number of nonces, from the next one to release, which can be buffered (rounded up to a power of 2).
+	// Defaults to 1024.
+	Capacity int
+	// HoleTimeout is how long a missing nonce holds back the txs buffered after it before it's skipped. Defaults to 10ms.
+	HoleTimeout time.Duration
+}
+
+// ReorderItem is a released tx, or a skipped nonce if Hole is set
+type ReorderItem struct {
+	Nonce int64
+	Tx    txtypes.TxInfo
+	Hole  bool
+}
+
+type ReorderStats struct {
+	Released uint64
+	Holes    uint64
+	Buffered uint64
+	// Refused inserts: nonces already released or skipped, duplicates and nonces past the window
+	Refused uint64
+}
+
+type reorderSlot struct {
+	nonce int64
+	tx    txtypes.TxInfo
+}
+
+// ReorderBuffer takes the signed txs of one API key in any order, from any number of goroutines,
+// and releases them strictly in nonce order to a single consumer.
+//
+// Insert takes no lock: the tx is published into the slot of its nonce with a CAS. The consumer calls Drain when
+// Ready fires, and periodically so holes time out: once the next nonce has been missing for HoleTimeout while later
+// txs are buffered, it's released as a hole (e.g. to fill it with NonceReconciler) and the txs after it follow.
+type ReorderBuffer struct {
+	cfg   ReorderConfig
+	mask  int64
+	slots []atomic.Pointer[reorderSlot]
+	next  atomic.Int64
+	ready chan struct{}
+
+	inserted atomic.Uint64
+	released atomic.Uint64
+	holes    atomic.Uint64
+	refused  atomic.Uint64
+
+	// consumer side only
+	holeNonce int64
+	holeSince time.Time
+}
+
+func NewReorderBuffer(cfg ReorderConfig) *ReorderBuffer {
+	if cfg.Capacity <= 0 {
+		cfg.Capacity = 1024
+	}
+	if cfg.HoleTimeout <= 0 {
+		cfg.HoleTimeout = 10 * time.Millisecond
+	}
+	capacity := 1
+	for capacity < cfg.Capacity {
+		capacity <<= 1
+	}
+	cfg.Capacity = capacity
+
+	b := &ReorderBuffer{
+		cfg:       cfg,
+		mask:      int64(capacity - 1),
+		slots:     make([]atomic.Pointer[reorderSlot], capacity),
+		ready:     make(chan struct{}, 1),
+		holeNonce: -1,
+	}
+	b.next.Store(cfg.FirstNonce)
+	return b
+}
+
+// Insert buffers a signed tx. It fails if the nonce was already released or skipped, is already buffered,
+// or is Capacity or more ahead of the next nonce to release.
+// It only waits while the slot of nonce holds a late insert of an earlier nonce, until that one is taken back.
+func (b *ReorderBuffer) Insert(nonce int64, tx txtypes.TxInfo) error {
+	if tx == nil {
+		return errReorderEmptyInsert
+	}
+	next := b.next.Load()
+	switch {
+	case nonce < next:
+		b.refused.Add(1)
+		return ErrNonceReleased
+	case nonce-next >= int64(len(b.slots)):
+		b.refused.Add(1)
+		return ErrReorderWindowFull
+	}
+	// Counted before publishing, so released never gets ahead of inserted.
+	b.inserted.Add(1)
+	slot := &b.slots[nonce&b.mask]
+	s := &reorderSlot{nonce: nonce, tx: tx}
+	for !slot.CompareAndSwap(nil, s) {
+		cur := slot.Load()
+		switch {
+		case cur == nil:
+			// released or taken back meanwhile
+		case nonce < b.next.Load():
+			b.inserted.Add(^uint64(0))
+			b.refused.Add(1)
+			return ErrNonceReleased
+		case cur.nonce == nonce:
+			b.inserted.Add(^uint64(0))
+			b.refused.Add(1)
+			return ErrNonceBuffered
+		default:
+			// a late insert of an earlier nonce, below next, which its inserter is about to take back
+			runtime.Gosched()
+		}
+	}
+	// next may have moved past nonce since it was checked: take the tx back, unless the consumer released it meanwhile
+	if nonce < b.next.Load() && slot.CompareAndSwap(s, nil) {
+		b.inserted.Add(^uint64(0))
+		b.refused.Add(1)
+		return ErrNonceReleased
+	}
+
+	// The consumer stores next before looking at the slot again, so either it sees this tx,
+	// or this load sees next == nonce and wakes it up.
+	if b.next.Load() == nonce {
+		select {
+		case b.ready <- struct{}{}:
+		default:
+		}
+	}
+	return nil
+}
+
+// Ready is signaled when the next nonce to release was inserted
+func (b *ReorderBuffer) Ready() <-chan struct{} {
+	return b.ready
+}
+
+// Next returns the next nonce to release
+func (b *ReorderBuffer) Next() int64 {
+	return b.next.Load()
+}
+
+// Drain releases the buffered txs which are next in nonce order, skipping holes which timed out, and returns
+// how many items were released. It must only be called from one goroutine at a time.
+func (b *ReorderBuffer) Drain(release func(item ReorderItem)) int {
+	n := 0
+	for {
+		next := b.next.Load()
+		slot := &b.slots[next&b.mask]
+		// a slot holding an older nonce is a late insert, which its inserter takes back
+		if s := slot.Load(); s != nil && s.nonce == next {
+			slot.Store(nil)
+			b.next.Store(next + 1)
+			b.released.Add(1)
+			release(ReorderItem{Nonce: s.nonce, Tx: s.tx})
+			n++
+			continue
+		}
+
+		// nothing behind the hole: it's not holding anything back
+		if b.inserted.Load() == b.released.Load() {
+			b.holeNonce = -1
+			return n
+		}
+		now := time.Now()
+		if b.holeNonce != next {
+			b.holeNonce, b.holeSince = next, now
+			return n
+		}
+		if now.Sub(b.holeSince) < b.cfg.HoleTimeout {
+			return n
+		}
+		b.next.Store(next + 1)
+		b.holes.Add(1)
+		release(ReorderItem{Nonce: next, Hole: true})
+		n++
+	}
+}
+
+func (b *ReorderBuffer) Stats() ReorderStats {
+	released := b.released.Load()
+	return ReorderStats{
+		Released: released,
+		Holes:    b.holes.Load(),
+		Buffered: b.inserted.Load() - released,
+		Refused:  b.refused.Load(),
+	}
+}
@@ -0,0 +1,166 @@
+package client
+
+import (
+	"errors"
+	"runtime"
+	"sync"
+	"sync/atomic"
+	"testing"
+	"time"
+
+	"github.com/elliottech/lighter-go/types/txtypes"
+)
+
+func reorderTestTx(nonce int64) txtypes.TxInfo {
+	return &txtypes.L2CancelOrderTxInfo{Nonce: nonce}
+}
+
+// runReorderConsumer drains b on Ready and every millisecond until stop is closed, then drains once more
+func runReorderConsumer(b *ReorderBuffer, stop <-chan struct{}, release func(ReorderItem)) <-chan struct{} {
+	done := make(chan struct{})
+	go func() {
+		defer close(done)
+		ticker := time.NewTicker(time.Millisecond)
+		defer ticker.Stop()
+		for {
+			select {
+			case <-b.Ready():
+			case <-ticker.C:
+			case <-stop:
+				b.Drain(release)
+				return
+			}
+			b.Drain(release)
+		}
+	}()
+	return done
+}
+
+func TestReorderBufferConcurrentInserts(t *testing.T) {
+	const (
+		n       = 20000
+		writers = 8
+	)
+	b := NewReorderBuffer(ReorderConfig{FirstNonce: 100, Capacity: 256, HoleTimeout: time.Minute})
+	next := int64(100)
+	stop := make(chan struct{})
+	done := runReorderConsumer(b, stop, func(item ReorderItem) {
+		if item.Hole || item.Nonce != next || item.Tx.(*txtypes.L2CancelOrderTxInfo).Nonce != next {
+			t.Errorf("released %+v, want nonce %d", item, next)
+		}
+		next++
+	})
+
+	// writers take nonces in order but finish in any order, like signing workers
+	var (
+		nonces atomic.Int64
+		wg     sync.WaitGroup
+	)
+	nonces.Store(100)
+	for w := 0; w < writers; w++ {
+		wg.Add(1)
+		go func() {
+			defer wg.Done()
+			for nonce := nonces.Add(1) - 1; nonce < 100+n; nonce = nonces.Add(1) - 1 {
+				if nonce%7 == 0 {
+					runtime.Gosched()
+				}
+				for {
+					err := b.Insert(nonce, reorderTestTx(nonce))
+					if err == nil {
+						break
+					}
+					if !errors.Is(err, ErrReorderWindowFull) {
+						t.Errorf("Insert %d: %v", nonce, err)
+						return
+					}
+					runtime.Gosched()
+				}
+			}
+		}()
+	}
+	wg.Wait()
+	for b.Next() < 100+n {
+		time.Sleep(time.Millisecond)
+	}
+	close(stop)
+	<-done
+
+	if s := b.Stats(); s.Released != n || s.Buffered != 0 || s.Holes != 0 {
+		t.Errorf("stats = %+v", s)
+	}
+}
+
+func TestReorderBufferHoleTimeout(t *testing.T) {
+	b := NewReorderBuffer(ReorderConfig{Capacity: 4, HoleTimeout: 50 * time.Millisecond})
+	var released []ReorderItem
+	collect := func(item ReorderItem) { released = append(released, item) }
+
+	for _, nonce := range []int64{0, 2} {
+		if err := b.Insert(nonce, reorderTestTx(nonce)); err != nil {
+			t.Fatal(err)
+		}
+	}
+	if err := b.Insert(2, reorderTestTx(2)); !errors.Is(err, ErrNonceBuffered) {
+		t.Errorf("err = %v, want ErrNonceBuffered", err)
+	}
+	if err := b.Insert(4, reorderTestTx(4)); !errors.Is(err, ErrReorderWindowFull) {
+		t.Errorf("err = %v, want ErrReorderWindowFull", err)
+	}
+
+	// 1 is missing: the first drain only releases 0 and starts timing the hole
+	if b.Drain(collect) != 1 || b.Drain(collect) != 0 {
+		t.Fatalf("released = %+v", released)
+	}
+	time.Sleep(60 * time.Millisecond)
+	if b.Drain(collect) != 2 {
+		t.Fatalf("released = %+v", released)
+	}
+	if !released[1].Hole || released[1].Nonce != 1 || released[2].Hole || released[2].Nonce != 2 {
+		t.Errorf("released = %+v", released)
+	}
+	if err := b.Insert(1, reorderTestTx(1)); !errors.Is(err, ErrNonceReleased) {
+		t.Errorf("err = %v, want ErrNonceReleased", err)
+	}
+	if s := b.Stats(); s.Released != 2 || s.Holes != 1 || s.Refused != 3 {
+		t.Errorf("stats = %+v", s)
+	}
+
+	// a late insert of 1 still holds its slot until its inserter takes it back: 5 waits for it rather than failing
+	b.slots[1].Store(&reorderSlot{nonce: 1, tx: reorderTestTx(1)})
+	inserted := make(chan error, 1)
+	go func() { inserted <- b.Insert(5, reorderTestTx(5)) }()
+	select {
+	case err := <-inserted:
+		t.Fatalf("Insert returned %v while the slot was held", err)
+	case <-time.After(10 * time.Millisecond):
+	}
+	b.slots[1].Store(nil)
+	if err := <-inserted; err != nil {
+		t.Errorf("Insert 5: %v", err)
+	}
+	if err := b.Insert(5, reorderTestTx(5)); !errors.Is(err, ErrNonceBuffered) {
+		t.Errorf("err = %v, want ErrNonceBuffered", err)
+	}
+}
+
+func BenchmarkReorderBufferInsert(b *testing.B) {
+	buf := NewReorderBuffer(ReorderConfig{Capacity: 1 << 16})
+	stop := make(chan struct{})
+	done := runReorderConsumer(buf, stop, func(ReorderItem) {})
+	tx := reorderTestTx(0)
+	var nonces atomic.Int64
+
+	b.ResetTimer()
+	b.RunParallel(func(pb *testing.PB) {
+		for pb.Next() {
+			nonce := nonces.Add(1) - 1
+			for errors.Is(buf.Insert(nonce, tx), ErrReorderWindowFull) {
+				runtime.Gosched()
+			}
+		}
+	})
+	b.StopTimer()
+	close(stop)
+	<-done
+}
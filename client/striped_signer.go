@@ -0,0 +1,213 @@
+package client
+
+import (
+	"errors"
+	"fmt"
+	"sync/atomic"
+
+	"github.com/elliottech/lighter-go/types"
+	"github.com/elliottech/lighter-go/types/txtypes"
+)
+
+var (
+	ErrUnknownStripedKey  = errors.New("API key is not part of the striped signer")
+	ErrStripedNotInFlight = errors.New("API key has no tx in flight")
+	// ErrStripedNonceGap is wrapped by Sign errors which left the nonce unused, see Sign
+	ErrStripedNonceGap = errors.New("nonce left unused")
+)
+
+type StripedSignerConfig struct {
+	// NextNonce returns the first nonce of a key. Defaults to calling GetNextNonce.
+	NextNonce func(c *TxClient) (int64, error)
+}
+
+// StripedTx is a tx signed by a StripedSigner, with the key & nonce it was assigned
+type StripedTx struct {
+	TxInfo      txtypes.TxInfo
+	ApiKeyIndex uint8
+	Nonce       int64
+}
+
+type StripedKeyStats struct {
+	ApiKeyIndex uint8
+	NextNonce   int64
+	// InFlight txs are being signed, or were signed and not released with Done yet
+	InFlight int64
+	Signed   uint64
+	// Failed txs whose nonce couldn't be handed back, leaving a gap (see NonceReconciler)
+	Failed uint64
+}
+
+type stripedKey struct {
+	client   *TxClient
+	next     atomic.Int64
+	inFlight atomic.Int64
+	signed   atomic.Uint64
+	failed   atomic.Uint64
+}
+
+// StripedSigner signs the order flow of one account over several of its API keys. Every key is its own nonce
+// stream, so spreading txs over K keys lets K of them be in flight at once, where a single key serializes them.
+//
+// Sign picks the key with the fewest txs in flight, takes its next local nonce and signs; txs are in flight until
+// Done is called for them, typically once the exchange answered. Txs of one key must still reach the exchange in
+// nonce order: send them from one goroutine per key, or put them back in order with a ReorderBuffer per key.
+// Sign is safe for concurrent use and lock-free.
+type StripedSigner struct {
+	accountIndex int64
+	keys         []*stripedKey
+	byIndex      [txtypes.MaxApiKeyIndex + 1]*stripedKey
+	// rotates the first key looked at, so ties don't always go to the same key
+	cursor atomic.Uint32
+}
+
+// NewStripedSigner takes the clients of the API keys to use, all of the same account
+func NewStripedSigner(clients []*TxClient, cfg StripedSignerConfig) (*StripedSigner, error) {
+	if len(clients) == 0 {
+		return nil, fmt.Errorf("striped signer needs at least one client")
+	}
+	if cfg.NextNonce == nil {
+		cfg.NextNonce = func(c *TxClient) (int64, error) {
+			if c.HTTP() == nil {
+				return 0, fmt.Errorf("HTTPClient is nil, NextNonce must be provided")
+			}
+			return c.HTTP().GetNextNonce(c.accountIndex, c.apiKeyIndex)
+		}
+	}
+
+	s := &StripedSigner{accountIndex: clients[0].accountIndex}
+	for _, c := range clients {
+		switch {
+		case c.accountIndex != s.accountIndex:
+			return nil, fmt.Errorf("striped signer clients must share an account, got %d and %d", s.accountIndex, c.accountIndex)
+		case c.apiKeyIndex > txtypes.MaxApiKeyIndex:
+			return nil, fmt.Errorf("invalid API key index %d", c.apiKeyIndex)
+		case s.byIndex[c.apiKeyIndex] != nil:
+			return nil, fmt.Errorf("API key %d is used twice", c.apiKeyIndex)
+		}
+		nonce, err := cfg.NextNonce(c)
+		if err != nil {
+			return nil, fmt.Errorf("API key %d: %w", c.apiKeyIndex, err)
+		}
+		k := &stripedKey{client: c}
+		k.next.Store(nonce)
+		s.keys = append(s.keys, k)
+		s.byIndex[c.apiKeyIndex] = k
+	}
+	return s, nil
+}
+
+func (s *StripedSigner) AccountIndex() int64 {
+	return s.accountIndex
+}
+
+// Sign signs an order-flow request (same types as PipelineRequest.Tx) with the least loaded key.
+// The account, API key & nonce of ops are overridden; nil ops use the defaults of TxClient.FullFillDefaultOps.
+// On success the tx is in flight until Done is called with its ApiKeyIndex.
+// A failed tx hands its nonce back, unless a later one of the key was taken meanwhile: then the error wraps
+// ErrStripedNonceGap and the returned StripedTx holds the key & nonce to fill (with a NonceReconciler cancel, or SetNextNonce).
+func (s *StripedSigner) Sign(req any, ops *types.TransactOpts) (StripedTx, error) {
+	if _, ok := pipelineTxType(req); !ok {
+		return StripedTx{}, fmt.Errorf("unsupported striped signer request type %T", req)
+	}
+	k := s.pick()
+	k.inFlight.Add(1)
+
+	var o types.TransactOpts
+	if ops != nil {
+		o = *ops
+	}
+	nonce := k.next.Add(1) - 1
+	o.FromAccountIndex, o.ApiKeyIndex, o.Nonce = &k.client.accountIndex, &k.client.apiKeyIndex, &nonce
+	filled, err := k.client.FullFillDefaultOps(&o)
+	if err != nil {
+		return s.fail(k, nonce, err)
+	}
+
+	job := &pipelineJob{req: PipelineRequest{Client: k.client, Tx: req, Ops: filled}}
+	runPipelineStage(job, hashPipelineJob)
+	if job.result.Err == nil {
+		runPipelineStage(job, signPipelineJob)
+	}
+	if job.result.Err != nil {
+		return s.fail(k, nonce, job.result.Err)
+	}
+	k.signed.Add(1)
+	return StripedTx{TxInfo: job.tx, ApiKeyIndex: k.client.apiKeyIndex, Nonce: nonce}, nil
+}
+
+// Done releases a tx signed with apiKeyIndex, once it was sent & answered (or dropped).
+// Releasing more txs than were signed fails with ErrStripedNotInFlight, rather than skewing the load of the key.
+func (s *StripedSigner) Done(apiKeyIndex uint8) error {
+	k := s.key(apiKeyIndex)
+	if k == nil {
+		return ErrUnknownStripedKey
+	}
+	for {
+		n := k.inFlight.Load()
+		if n <= 0 {
+			return ErrStripedNotInFlight
+		}
+		if k.inFlight.CompareAndSwap(n, n-1) {
+			return nil
+		}
+	}
+}
+
+// SetNextNonce restarts the nonces of a key, e.g. after its txs were rejected.
+// Txs signed with the key meanwhile may use nonces of the previous sequence.
+func (s *StripedSigner) SetNextNonce(apiKeyIndex uint8, nonce int64) error {
+	k := s.key(apiKeyIndex)
+	if k == nil {
+		return ErrUnknownStripedKey
+	}
+	k.next.Store(nonce)
+	return nil
+}
+
+func (s *StripedSigner) Stats() []StripedKeyStats {
+	stats := make([]StripedKeyStats, len(s.keys))
+	for i, k := range s.keys {
+		stats[i] = StripedKeyStats{
+			ApiKeyIndex: k.client.apiKeyIndex,
+			NextNonce:   k.next.Load(),
+			InFlight:    k.inFlight.Load(),
+			Signed:      k.signed.Load(),
+			Failed:      k.failed.Load(),
+		}
+	}
+	return stats
+}
+
+func (s *StripedSigner) key(apiKeyIndex uint8) *stripedKey {
+	if apiKeyIndex > txtypes.MaxApiKeyIndex {
+		return nil
+	}
+	return s.byIndex[apiKeyIndex]
+}
+
+// pick returns the key with the fewest txs in flight
+func (s *StripedSigner) pick() *stripedKey {
+	n := len(s.keys)
+	start := int(s.cursor.Add(1)) % n
+	best := s.keys[start]
+	bestLoad := best.inFlight.Load()
+	for i := 1; i < n && bestLoad > 0; i++ {
+		k := s.keys[(start+i)%n]
+		if load := k.inFlight.Load(); load < bestLoad {
+			best, bestLoad = k, load
+		}
+	}
+	return best
+}
+
+// fail hands the nonce back if no later one was taken meanwhile, otherwise it's left as a gap
+func (s *StripedSigner) fail(k *stripedKey, nonce int64, err error) (StripedTx, error) {
+	k.inFlight.Add(-1)
+	if !k.next.CompareAndSwap(nonce+1, nonce) {
+		k.failed.Add(1)
+		gap := StripedTx{ApiKeyIndex: k.client.apiKeyIndex, Nonce: nonce}
+		return gap, fmt.Errorf("API key %d, nonce %d: %w: %w", k.client.apiKeyIndex, nonce, ErrStripedNonceGap, err)
+	}
+	return StripedTx{}, err
+}
@@ -0,0 +1,156 @@
+package client
+
+import (
+	"errors"
+	"fmt"
+	"sync"
+	"testing"
+	"time"
+
+	"github.com/elliottech/lighter-go/types"
+	"github.com/elliottech/lighter-go/types/txtypes"
+)
+
+func newStripedTestSigner(tb testing.TB, k int) *StripedSigner {
+	tb.Helper()
+	s, err := NewStripedSigner(newPipelineTestClients(tb, k), StripedSignerConfig{
+		NextNonce: func(c *TxClient) (int64, error) { return 1000 * int64(c.GetApiKeyIndex()), nil },
+	})
+	if err != nil {
+		tb.Fatal(err)
+	}
+	return s
+}
+
+func TestStripedSigner(t *testing.T) {
+	const (
+		keys    = 4
+		workers = 8
+		perKey  = 50
+	)
+	s := newStripedTestSigner(t, keys)
+
+	// nothing is released: least loaded means round robin
+	for i := 0; i < keys*perKey; i++ {
+		if _, err := s.Sign(pipelineTestOrder(i), nil); err != nil {
+			t.Fatal(err)
+		}
+	}
+	for _, st := range s.Stats() {
+		if st.Signed != perKey || st.InFlight != perKey || st.NextNonce != 1000*int64(st.ApiKeyIndex)+perKey {
+			t.Errorf("stats = %+v", st)
+		}
+		for i := 0; i < perKey; i++ {
+			if err := s.Done(st.ApiKeyIndex); err != nil {
+				t.Fatal(err)
+			}
+		}
+	}
+
+	// concurrently, every key still hands out each nonce once
+	var (
+		mu     sync.Mutex
+		nonces = map[uint8][]bool{}
+		wg     sync.WaitGroup
+	)
+	for w := 0; w < workers; w++ {
+		wg.Add(1)
+		go func() {
+			defer wg.Done()
+			for i := 0; i < keys*perKey/workers; i++ {
+				tx, err := s.Sign(pipelineTestOrder(i), nil)
+				if err != nil {
+					t.Error(err)
+					return
+				}
+				info := tx.TxInfo.(*txtypes.L2CreateOrderTxInfo)
+				if info.Nonce != tx.Nonce || info.ApiKeyIndex != tx.ApiKeyIndex || info.SignedHash == "" {
+					t.Errorf("tx = %+v, info = %+v", tx, info)
+				}
+				mu.Lock()
+				seen := nonces[tx.ApiKeyIndex]
+				for int64(len(seen)) <= tx.Nonce-1000*int64(tx.ApiKeyIndex)-perKey {
+					seen = append(seen, false)
+				}
+				seen[tx.Nonce-1000*int64(tx.ApiKeyIndex)-perKey] = true
+				nonces[tx.ApiKeyIndex] = seen
+				mu.Unlock()
+				_ = s.Done(tx.ApiKeyIndex)
+			}
+		}()
+	}
+	wg.Wait()
+	total := 0
+	for key, seen := range nonces {
+		for i, ok := range seen {
+			if !ok {
+				t.Errorf("key %d skipped nonce %d", key, 1000*int(key)+perKey+i)
+			}
+		}
+		total += len(seen)
+	}
+	if total != keys*perKey {
+		t.Errorf("signed %d txs, want %d", total, keys*perKey)
+	}
+
+	// a request which fails validation hands its nonce back
+	before := s.Stats()
+	bad := pipelineTestOrder(0)
+	bad.Price = 0
+	if _, err := s.Sign(bad, nil); err == nil {
+		t.Error("expected a validation error")
+	}
+	if _, err := s.Sign(&types.WithdrawTxReq{}, nil); err == nil {
+		t.Error("expected an unsupported request error")
+	}
+	if after := s.Stats(); fmt.Sprint(after) != fmt.Sprint(before) {
+		t.Errorf("stats = %+v, want %+v", after, before)
+	}
+	if err := s.Done(200); err != ErrUnknownStripedKey {
+		t.Errorf("err = %v, want ErrUnknownStripedKey", err)
+	}
+	if err := s.Done(before[0].ApiKeyIndex); err != ErrStripedNotInFlight {
+		t.Errorf("err = %v, want ErrStripedNotInFlight", err)
+	}
+
+	// a failure after a later nonce of the key was taken leaves a gap
+	k := s.keys[0]
+	k.inFlight.Add(1)
+	nonce := k.next.Add(1) - 1
+	k.next.Add(1)
+	gap, err := s.fail(k, nonce, fmt.Errorf("signing failed"))
+	if !errors.Is(err, ErrStripedNonceGap) || gap.ApiKeyIndex != k.client.apiKeyIndex || gap.Nonce != nonce || gap.TxInfo != nil {
+		t.Errorf("gap = %+v, err = %v", gap, err)
+	}
+	if st := s.Stats()[0]; st.Failed != 1 || st.InFlight != 0 {
+		t.Errorf("stats = %+v", st)
+	}
+}
+
+// BenchmarkStripedSigner models an account whose keys each have one tx on the wire at a time, for stripedRoundTrip,
+// so throughput scales with the number of keys until signing saturates the CPUs.
+func BenchmarkStripedSigner(b *testing.B) {
+	const stripedRoundTrip = 200 * time.Microsecond
+	for _, k := range []int{1, 2, 4, 8, 16} {
+		b.Run(fmt.Sprintf("keys=%d", k), func(b *testing.B) {
+			s := newStripedTestSigner(b, k)
+			var wire [txtypes.MaxApiKeyIndex + 1]sync.Mutex
+			b.SetParallelism(32)
+			b.ResetTimer()
+			b.RunParallel(func(pb *testing.PB) {
+				for i := 0; pb.Next(); i++ {
+					tx, err := s.Sign(pipelineTestOrder(i), nil)
+					if err != nil {
+						b.Error(err)
+						return
+					}
+					wire[tx.ApiKeyIndex].Lock()
+					time.Sleep(stripedRoundTrip)
+					wire[tx.ApiKeyIndex].Unlock()
+					_ = s.Done(tx.ApiKeyIndex)
+				}
+			})
+			b.ReportMetric(float64(b.N)/b.Elapsed().Seconds(), "txs/s")
+		})
+	}
+}
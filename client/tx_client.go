@@ -7,6 +7,7 @@ import (
 
 	"github.com/elliottech/lighter-go/signer"
 	"github.com/elliottech/lighter-go/types"
+	"github.com/elliottech/lighter-go/types/txtypes"
 )
 
 var (
@@ -21,6 +22,9 @@ type TxClient struct {
 	keyManager   signer.KeyManager
 	accountIndex int64
 	apiKeyIndex  uint8
+
+	// shared with the clients registered for the same pair, see clientSlot
+	limits *rateLimits
 }
 
 // NewTxClient is linked to a specific (account, apiKey) pair
@@ -50,6 +54,7 @@ func NewTxClient(apiClient MinimalHTTPClient, apiKeyPrivateKey string, accountIn
 		accountIndex: accountIndex,
 		chainId:      chainId,
 		keyManager:   keyManager,
+		limits:       &rateLimits{},
 	}, nil
 }
 
@@ -83,6 +88,27 @@ func (c *TxClient) FullFillDefaultOps(ops *types.TransactOpts) (*types.TransactO
 	return ops, nil
 }
 
+// WarmUp signs & encodes a throwaway order, so the signing code is paged in and the calling goroutine's stack
+// is grown to its steady state size. Nothing is sent, and neither the nonces nor the rate limit budget are affected.
+func (c *TxClient) WarmUp() error {
+	nonce := int64(0)
+	tx := &types.CreateOrderTxReq{
+		MarketIndex:      0,
+		ClientOrderIndex: 1,
+		BaseAmount:       10000,
+		Price:            400000,
+		IsAsk:            1,
+		TimeInForce:      txtypes.PostOnly,
+		OrderExpiry:      time.Now().Add(time.Hour).UnixMilli(),
+	}
+	txInfo, err := c.signUnmetered(tx, &types.TransactOpts{Nonce: &nonce})
+	if err != nil {
+		return err
+	}
+	_, err = txInfo.GetTxInfo()
+	return err
+}
+
 func (c *TxClient) GetChainId() uint32 {
 	return c.chainId
 }
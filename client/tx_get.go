@@ -22,7 +22,7 @@ func (c *TxClient) GetChangePubKeyTransaction(tx *types.ChangePubKeyReq, ops *ty
 	if err != nil {
 		return nil, err
 	}
-	txInfo, err := types.ConstructChangePubKeyTx(c.keyManager, c.chainId, tx, ops)
+	txInfo, err := types.ConstructChangePubKeyTx(c.signerFor(txtypes.TxTypeL2ChangePubKey), c.chainId, tx, ops)
 	if err != nil {
 		return nil, err
 	}
@@ -47,7 +47,7 @@ func (c *TxClient) GetCreateSubAccountTransaction(ops *types.TransactOpts) (*txt
 	if err != nil {
 		return nil, err
 	}
-	txInfo, err := types.ConstructCreateSubAccountTx(c.keyManager, c.chainId, ops)
+	txInfo, err := types.ConstructCreateSubAccountTx(c.signerFor(txtypes.TxTypeL2CreateSubAccount), c.chainId, ops)
 	if err != nil {
 		return nil, err
 	}
@@ -59,7 +59,7 @@ func (c *TxClient) GetCreatePublicPoolTransaction(tx *types.CreatePublicPoolTxRe
 	if err != nil {
 		return nil, err
 	}
-	txInfo, err := types.ConstructCreatePublicPoolTx(c.keyManager, c.chainId, tx, ops)
+	txInfo, err := types.ConstructCreatePublicPoolTx(c.signerFor(txtypes.TxTypeL2CreatePublicPool), c.chainId, tx, ops)
 	if err != nil {
 		return nil, err
 	}
@@ -71,7 +71,7 @@ func (c *TxClient) GetUpdatePublicPoolTransaction(tx *types.UpdatePublicPoolTxRe
 	if err != nil {
 		return nil, err
 	}
-	txInfo, err := types.ConstructUpdatePublicPoolTx(c.keyManager, c.chainId, tx, ops)
+	txInfo, err := types.ConstructUpdatePublicPoolTx(c.signerFor(txtypes.TxTypeL2UpdatePublicPool), c.chainId, tx, ops)
 	if err != nil {
 		return nil, err
 	}
@@ -83,7 +83,7 @@ func (c *TxClient) GetTransferTransaction(tx *types.TransferTxReq, ops *types.Tr
 	if err != nil {
 		return nil, err
 	}
-	txInfo, err := types.ConstructTransferTx(c.keyManager, c.chainId, tx, ops)
+	txInfo, err := types.ConstructTransferTx(c.signerFor(txtypes.TxTypeL2Transfer), c.chainId, tx, ops)
 	if err != nil {
 		return nil, err
 	}
@@ -95,7 +95,7 @@ func (c *TxClient) GetWithdrawTransaction(tx *types.WithdrawTxReq, ops *types.Tr
 	if err != nil {
 		return nil, err
 	}
-	txInfo, err := types.ConstructWithdrawTx(c.keyManager, c.chainId, tx, ops)
+	txInfo, err := types.ConstructWithdrawTx(c.signerFor(txtypes.TxTypeL2Withdraw), c.chainId, tx, ops)
 	if err != nil {
 		return nil, err
 	}
@@ -108,7 +108,7 @@ func (c *TxClient) GetCreateOrderTransaction(tx *types.CreateOrderTxReq, ops *ty
 	if err != nil {
 		return nil, err
 	}
-	txInfo, err := types.ConstructCreateOrderTx(c.keyManager, c.chainId, tx, ops)
+	txInfo, err := types.ConstructCreateOrderTx(c.signerFor(txtypes.TxTypeL2CreateOrder), c.chainId, tx, ops)
 	if err != nil {
 		return nil, err
 	}
@@ -120,7 +120,7 @@ func (c *TxClient) GetCreateGroupedOrdersTransaction(tx *types.CreateGroupedOrde
 	if err != nil {
 		return nil, err
 	}
-	txInfo, err := types.ConstructL2CreateGroupedOrdersTx(c.keyManager, c.chainId, tx, ops)
+	txInfo, err := types.ConstructL2CreateGroupedOrdersTx(c.signerFor(txtypes.TxTypeL2CreateGroupedOrders), c.chainId, tx, ops)
 	if err != nil {
 		return nil, err
 	}
@@ -132,7 +132,7 @@ func (c *TxClient) GetCancelOrderTransaction(tx *types.CancelOrderTxReq, ops *ty
 	if err != nil {
 		return nil, err
 	}
-	txInfo, err := types.ConstructL2CancelOrderTx(c.keyManager, c.chainId, tx, ops)
+	txInfo, err := types.ConstructL2CancelOrderTx(c.signerFor(txtypes.TxTypeL2CancelOrder), c.chainId, tx, ops)
 	if err != nil {
 		return nil, err
 	}
@@ -145,7 +145,7 @@ func (c *TxClient) GetModifyOrderTransaction(tx *types.ModifyOrderTxReq, ops *ty
 		return nil, err
 	}
 
-	txInfo, err := types.ConstructL2ModifyOrderTx(c.keyManager, c.chainId, tx, ops)
+	txInfo, err := types.ConstructL2ModifyOrderTx(c.signerFor(txtypes.TxTypeL2ModifyOrder), c.chainId, tx, ops)
 	if err != nil {
 		return nil, err
 	}
@@ -158,7 +158,7 @@ func (c *TxClient) GetCancelAllOrdersTransaction(tx *types.CancelAllOrdersTxReq,
 	if err != nil {
 		return nil, err
 	}
-	txInfo, err := types.ConstructL2CancelAllOrdersTx(c.keyManager, c.chainId, tx, ops)
+	txInfo, err := types.ConstructL2CancelAllOrdersTx(c.signerFor(txtypes.TxTypeL2CancelAllOrders), c.chainId, tx, ops)
 	if err != nil {
 		return nil, err
 	}
@@ -170,7 +170,7 @@ func (c *TxClient) GetMintSharesTransaction(tx *types.MintSharesTxReq, ops *type
 	if err != nil {
 		return nil, err
 	}
-	txInfo, err := types.ConstructMintSharesTx(c.keyManager, c.chainId, tx, ops)
+	txInfo, err := types.ConstructMintSharesTx(c.signerFor(txtypes.TxTypeL2MintShares), c.chainId, tx, ops)
 	if err != nil {
 		return nil, err
 	}
@@ -182,7 +182,7 @@ func (c *TxClient) GetBurnSharesTransaction(tx *types.BurnSharesTxReq, ops *type
 	if err != nil {
 		return nil, err
 	}
-	txInfo, err := types.ConstructBurnSharesTx(c.keyManager, c.chainId, tx, ops)
+	txInfo, err := types.ConstructBurnSharesTx(c.signerFor(txtypes.TxTypeL2BurnShares), c.chainId, tx, ops)
 	if err != nil {
 		return nil, err
 	}
@@ -194,7 +194,7 @@ func (c *TxClient) GetUpdateLeverageTransaction(tx *types.UpdateLeverageTxReq, o
 	if err != nil {
 		return nil, err
 	}
-	txInfo, err := types.ConstructUpdateLeverageTx(c.keyManager, c.chainId, tx, ops)
+	txInfo, err := types.ConstructUpdateLeverageTx(c.signerFor(txtypes.TxTypeL2UpdateLeverage), c.chainId, tx, ops)
 	if err != nil {
 		return nil, err
 	}
@@ -206,7 +206,7 @@ func (c *TxClient) GetUpdateMarginTransaction(tx *types.UpdateMarginTxReq, ops *
 	if err != nil {
 		return nil, err
 	}
-	txInfo, err := types.ConstructUpdateMarginTx(c.keyManager, c.chainId, tx, ops)
+	txInfo, err := types.ConstructUpdateMarginTx(c.signerFor(txtypes.TxTypeL2UpdateMargin), c.chainId, tx, ops)
 	if err != nil {
 		return nil, err
 	}
@@ -218,7 +218,7 @@ func (c *TxClient) GetStakeAssetsTransaction(tx *types.StakeAssetsTxReq, ops *ty
 	if err != nil {
 		return nil, err
 	}
-	txInfo, err := types.ConstructStakeAssetsTx(c.keyManager, c.chainId, tx, ops)
+	txInfo, err := types.ConstructStakeAssetsTx(c.signerFor(txtypes.TxTypeL2StakeAssets), c.chainId, tx, ops)
 	if err != nil {
 		return nil, err
 	}
@@ -230,7 +230,7 @@ func (c *TxClient) GetUnstakeAssetsTransaction(tx *types.UnstakeAssetsTxReq, ops
 	if err != nil {
 		return nil, err
 	}
-	txInfo, err := types.ConstructUnstakeAssetsTx(c.keyManager, c.chainId, tx, ops)
+	txInfo, err := types.ConstructUnstakeAssetsTx(c.signerFor(txtypes.TxTypeL2UnstakeAssets), c.chainId, tx, ops)
 	if err != nil {
 		return nil, err
 	}
@@ -242,7 +242,7 @@ func (c *TxClient) GetApproveIntegratorTx(tx *types.ApproveIntegratorTxReq, ops
 	if err != nil {
 		return nil, err
 	}
-	txInfo, err := types.ConstructApproveIntegratorTx(c.keyManager, c.chainId, tx, ops)
+	txInfo, err := types.ConstructApproveIntegratorTx(c.signerFor(txtypes.TxTypeL2ApproveIntegrator), c.chainId, tx, ops)
 	if err != nil {
 		return nil, err
 	}
@@ -262,7 +262,7 @@ func (c *TxClient) GetUpdateAccountConfigTransaction(tx *types.UpdateAccountConf
 	if err != nil {
 		return nil, err
 	}
-	txInfo, err := types.ConstructUpdateAccountConfigTx(c.keyManager, c.chainId, tx, ops)
+	txInfo, err := types.ConstructUpdateAccountConfigTx(c.signerFor(txtypes.TxTypeL2UpdateAccountConfig), c.chainId, tx, ops)
 	if err != nil {
 		return nil, err
 	}
@@ -274,7 +274,7 @@ func (c *TxClient) GetUpdateAccountAssetConfigTransaction(tx *types.UpdateAccoun
 	if err != nil {
 		return nil, err
 	}
-	txInfo, err := types.ConstructUpdateAccountAssetConfigTx(c.keyManager, c.chainId, tx, ops)
+	txInfo, err := types.ConstructUpdateAccountAssetConfigTx(c.signerFor(txtypes.TxTypeL2UpdateAccountAssetConfig), c.chainId, tx, ops)
 	if err != nil {
 		return nil, err
 	}
@@ -0,0 +1,120 @@
+// Call overhead benchmark, meant to be linked both against the c-shared library (`just build-cpp-bench`)
+// and statically against the c-archive (`just build-cpp-bench-static`).
+//
+//   ./bench-cpp                 first-call and steady state per-call latency
+//   ./bench-cpp --startup       one call and exit, used to time process startup (`just bench-cpp-startup`)
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <vector>
+#if defined(LIGHTER_SIGNER_STATIC)
+  #include "../../build/lighter-signer-linux-static.h"
+#elif defined(__APPLE__)
+  #include "../../build/lighter-signer-darwin-arm64.h"
+#elif defined(__linux__)
+  #include "../../build/lighter-signer-linux.h"
+#elif defined(_WIN32)
+  #include "../../build/lighter-signer-windows.h"
+#endif
+using namespace std;
+
+
+uint64_t now_ns() {
+    using namespace std::chrono;
+    return duration_cast<nanoseconds>(
+        steady_clock::now().time_since_epoch()
+    ).count();
+}
+
+uint64_t now_ms() {
+    using namespace std::chrono;
+    return duration_cast<milliseconds>(
+        system_clock::now().time_since_epoch()
+    ).count();
+}
+
+void free_response(SignedTxResponse& resp) {
+    if (resp.err != nullptr) {
+        cerr << "sign" << '\t' << resp.err << '\n';
+        Free(resp.err);
+    }
+    if (resp.txInfo != nullptr) Free(resp.txInfo);
+    if (resp.txHash != nullptr) Free(resp.txHash);
+    if (resp.messageToSign != nullptr) Free(resp.messageToSign);
+}
+
+void report(const char* name, vector<uint64_t>& samples) {
+    sort(samples.begin(), samples.end());
+    uint64_t sum = 0;
+    for (auto s : samples) sum += s;
+    cout << name
+         << '\t' << "avg " << sum / samples.size() / 1000.0 << "us"
+         << '\t' << "p50 " << samples[samples.size() / 2] / 1000.0 << "us"
+         << '\t' << "p99 " << samples[samples.size() * 99 / 100] / 1000.0 << "us" << '\n';
+}
+
+int main(int argc, char** argv) {
+    const int apiKeyIndex = 0;
+    const long long accountIndex = 100;
+
+    // the first export call pays for binding the thread to the Go runtime
+    auto start = now_ns();
+    ApiKeyResponse apiResp = GenerateAPIKey();
+    auto firstCall = now_ns() - start;
+    if (apiResp.err != nullptr) {
+        cerr << "GenerateAPIKey" << '\t' << apiResp.err << '\n';
+        Free(apiResp.err);
+        return 1;
+    }
+
+    if (argc > 1 && strcmp(argv[1], "--startup") == 0) {
+        Free(apiResp.privateKey);
+        Free(apiResp.publicKey);
+        return 0;
+    }
+
+    auto clientErr = CreateClient(nullptr, apiResp.privateKey, 304, apiKeyIndex, accountIndex);
+    Free(apiResp.privateKey);
+    Free(apiResp.publicKey);
+    if (clientErr != nullptr) {
+        cerr << "CreateClient" << '\t' << clientErr << '\n';
+        Free(clientErr);
+        return 1;
+    }
+    cout << "first call" << '\t' << firstCall / 1000.0 << "us" << '\n';
+
+    const int iterations = 20000;
+    vector<uint64_t> cancelSamples, createSamples;
+    cancelSamples.reserve(iterations);
+    createSamples.reserve(iterations);
+
+    long long nonce = 1;
+    for (int i = 1; i <= iterations; i += 1) {
+        auto t0 = now_ns();
+        auto create = SignCreateOrder(
+            0, i, 10000, 400000, true,
+            /* cOrderType */ 0, /* cTimeInForce */ 2, /* cReduceOnly */ 0, /* cTriggerPrice */ 0,
+            now_ms() + 60 * 60 * 1000,
+            /* cIntegratorAccountIndex */ 0,
+            /* cIntegratorTakerFee */ 0,
+            /* cIntegratorMakerFee */ 0,
+            /* cSkipNonce */ 0,
+            nonce++, apiKeyIndex, accountIndex);
+        auto t1 = now_ns();
+        free_response(create);
+
+        auto t2 = now_ns();
+        auto cancel = SignCancelOrder(0, i, /* cSkipNonce */ 0, nonce++, apiKeyIndex, accountIndex);
+        auto t3 = now_ns();
+        free_response(cancel);
+
+        createSamples.push_back(t1 - t0);
+        cancelSamples.push_back(t3 - t2);
+    }
+
+    report("SignCreateOrder", createSamples);
+    report("SignCancelOrder", cancelSamples);
+    return 0;
+}
@@ -0,0 +1,138 @@
+// Completion ring wake-up benchmark: epoll on the eventfd vs busy polling the ring (linux only).
+// Build with `just build-cpp-completion-bench`, run as `LD_LIBRARY_PATH=./build ./build/completion-bench-cpp`
+//
+// latency: one request in flight, time from Submit to the completion being consumed, and the CPU time of the consuming thread
+// burst:   bursts of requests, completions consumed per eventfd signal
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <vector>
+#include <sys/epoll.h>
+#include <sys/resource.h>
+#include "../../build/lighter-signer-linux.h"
+#include "lighter_completions.hpp"
+using namespace std;
+
+
+const int apiKeyIndex = 0;
+const long long accountIndex = 100;
+const int iterations = 5000;
+const int bursts = 200;
+const int burstSize = 64;
+
+uint64_t now_ns() {
+    using namespace std::chrono;
+    return duration_cast<nanoseconds>(
+        steady_clock::now().time_since_epoch()
+    ).count();
+}
+
+uint64_t thread_cpu_ns() {
+    rusage usage;
+    getrusage(RUSAGE_THREAD, &usage);
+    return (usage.ru_utime.tv_sec + usage.ru_stime.tv_sec) * 1000000000ull
+         + (usage.ru_utime.tv_usec + usage.ru_stime.tv_usec) * 1000ull;
+}
+
+void check(const char* name, char* err) {
+    if (err != nullptr) {
+        cerr << name << '\t' << err << '\n';
+        Free(err);
+        exit(1);
+    }
+}
+
+void on_completion(Completion& c) {
+    if (c.err != nullptr) {
+        cerr << "completion " << c.requestId << '\t' << c.err << '\n';
+    }
+}
+
+void wait_epoll(int epfd) {
+    epoll_event ev;
+    while (epoll_wait(epfd, &ev, 1, -1) != 1) {
+    }
+}
+
+void latency(CompletionRing* ring, int epfd, bool busy, long long& nonce) {
+    vector<uint64_t> samples;
+    samples.reserve(iterations);
+
+    auto cpuStart = thread_cpu_ns();
+    auto wallStart = now_ns();
+    for (int i = 0; i < iterations; i += 1) {
+        auto t0 = now_ns();
+        check("SubmitCancelOrder", SubmitCancelOrder(ring->queueId, i, 0, i + 1, /* cSkipNonce */ 0, nonce++, apiKeyIndex, accountIndex));
+
+        uint64_t consumed = 0;
+        while (consumed == 0) {
+            if (busy) {
+                consumed = lighter_drain_ring(ring, on_completion);
+            } else {
+                wait_epoll(epfd);
+                consumed = lighter_drain(ring, on_completion);
+            }
+        }
+        samples.push_back(now_ns() - t0);
+    }
+    auto wall = now_ns() - wallStart;
+    auto cpu = thread_cpu_ns() - cpuStart;
+
+    sort(samples.begin(), samples.end());
+    cout << (busy ? "busy poll" : "epoll")
+         << '\t' << "p50 " << samples[samples.size() / 2] / 1000.0 << "us"
+         << '\t' << "p99 " << samples[samples.size() * 99 / 100] / 1000.0 << "us"
+         << '\t' << "consumer cpu " << 100.0 * cpu / wall << "%" << '\n';
+}
+
+void burst(CompletionRing* ring, int epfd, long long& nonce) {
+    auto signalsStart = __atomic_load_n(&ring->signals, __ATOMIC_SEQ_CST);
+    uint64_t total = 0;
+    for (int b = 0; b < bursts; b += 1) {
+        for (int i = 0; i < burstSize; i += 1) {
+            check("SubmitCancelOrder", SubmitCancelOrder(ring->queueId, i, 0, i + 1, /* cSkipNonce */ 0, nonce++, apiKeyIndex, accountIndex));
+        }
+        for (uint64_t consumed = 0; consumed < burstSize;) {
+            wait_epoll(epfd);
+            consumed += lighter_drain(ring, on_completion);
+        }
+        total += burstSize;
+    }
+    auto signals = __atomic_load_n(&ring->signals, __ATOMIC_SEQ_CST) - signalsStart;
+    cout << "burst " << burstSize
+         << '\t' << "completions " << total
+         << '\t' << "signals " << signals
+         << '\t' << "completions/signal " << double(total) / signals << '\n';
+}
+
+int main() {
+    ApiKeyResponse apiResp = GenerateAPIKey();
+    check("GenerateAPIKey", apiResp.err);
+    check("CreateClient", CreateClient(nullptr, apiResp.privateKey, 304, apiKeyIndex, accountIndex));
+    Free(apiResp.privateKey);
+    Free(apiResp.publicKey);
+
+    CompletionQueueResponse queue = CreateCompletionQueue(1024, 0);
+    check("CreateCompletionQueue", queue.err);
+    CompletionRing* ring = queue.ring;
+
+    int epfd = epoll_create1(0);
+    epoll_event ev{};
+    ev.events = EPOLLIN;
+    epoll_ctl(epfd, EPOLL_CTL_ADD, ring->eventFd, &ev);
+
+    long long nonce = 1;
+    latency(ring, epfd, false, nonce);
+    latency(ring, epfd, true, nonce);
+    burst(ring, epfd, nonce);
+
+    check("CloseCompletionQueue", CloseCompletionQueue(ring->queueId));
+    while (!lighter_closed(ring)) {
+        wait_epoll(epfd);
+        lighter_drain(ring, on_completion);
+    }
+    lighter_drain(ring, on_completion);
+    check("FreeCompletionQueue", FreeCompletionQueue(ring->queueId));
+    return 0;
+}
@@ -47,6 +47,14 @@ void run_example(int apiKeyIndex) {
 
     long long accountIndex = 100;
 
+    // bind this thread to the Go runtime & warm it up, so the first signature runs at steady state speed
+    auto warmErr = WarmThread(apiKeyIndex, accountIndex);
+    if (warmErr != nullptr) {
+        cerr << "WarmThread" << '\t' << warmErr << '\n';
+        Free(warmErr);
+        return;
+    }
+
     // create an auth token with expiry 7 hours in the future
     StrOrErr tokenResp = CreateAuthToken(0 , apiKeyIndex, accountIndex);
     if (tokenResp.err != nullptr) {
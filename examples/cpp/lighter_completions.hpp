@@ -0,0 +1,55 @@
+// Consumer side of the completion ring created by CreateCompletionQueue (linux only).
+//
+// Include the generated header before this file, then register ring->eventFd with epoll (EPOLLIN) and,
+// whenever it's readable:
+//
+//   lighter_drain(ring, [](Completion& c) {
+//       ... use c.requestId, c.txInfo, c.txHash or c.err ...
+//   });
+//
+// lighter_drain resets the eventfd, calls the handler for every completion in submission order and frees their strings.
+// It returns the number of completions consumed. lighter_drain_ring skips the eventfd, for callers which busy poll.
+// Once lighter_closed(ring) is true and a drain returned 0, no more completions will come
+// and FreeCompletionQueue(ring->queueId) can be called.
+#pragma once
+
+#include <cstdint>
+#include <unistd.h>
+
+inline uint64_t lighter_pending(CompletionRing* ring) {
+    return __atomic_load_n(&ring->head, __ATOMIC_SEQ_CST) - __atomic_load_n(&ring->tail, __ATOMIC_SEQ_CST);
+}
+
+inline bool lighter_closed(CompletionRing* ring) {
+    return __atomic_load_n(&ring->closed, __ATOMIC_SEQ_CST) != 0;
+}
+
+template <typename Handler>
+inline uint64_t lighter_drain_ring(CompletionRing* ring, Handler&& handler) {
+    const uint64_t mask = ring->capacity - 1;
+    uint64_t tail = __atomic_load_n(&ring->tail, __ATOMIC_SEQ_CST);
+    uint64_t consumed = 0;
+    for (;;) {
+        const uint64_t head = __atomic_load_n(&ring->head, __ATOMIC_SEQ_CST);
+        if (tail == head) {
+            return consumed;
+        }
+        for (; tail != head; tail += 1, consumed += 1) {
+            Completion& c = ring->slots[tail & mask];
+            handler(c);
+            if (c.txInfo != nullptr) Free(c.txInfo);
+            if (c.txHash != nullptr) Free(c.txHash);
+            if (c.err != nullptr) Free(c.err);
+        }
+        // publish the consumed slots, then look at head again: the library only signals
+        // when it sees tail caught up, so anything written meanwhile is picked up by this loop
+        __atomic_store_n(&ring->tail, tail, __ATOMIC_SEQ_CST);
+    }
+}
+
+template <typename Handler>
+inline uint64_t lighter_drain(CompletionRing* ring, Handler&& handler) {
+    uint64_t counter;
+    (void)!read(ring->eventFd, &counter, sizeof(counter)); // EAGAIN if nothing was signaled
+    return lighter_drain_ring(ring, handler);
+}
@@ -0,0 +1,133 @@
+// Runtime loader for the GOAMD64 variants of the linux/amd64 shared library (`just build-linux-amd64-variants`).
+//
+// Include the generated header (any variant, they're identical) before this file, then:
+//
+//   LighterSigner signer;
+//   std::string err;
+//   if (!lighter_load(signer, "./build", &err)) { ... }
+//   auto resp = signer.SignCancelOrder(...);
+//
+// lighter_load inspects CPUID once, dlopens the best matching variant (v4, v3 or v1)
+// and resolves every export into the function table, so calls go through a plain function pointer.
+#pragma once
+
+#include <dlfcn.h>
+#include <cpuid.h>
+#include <cstdint>
+#include <string>
+
+#define LIGHTER_SIGNER_EXPORTS(X) \
+    X(GenerateAPIKey)               \
+    X(CreateClient)                 \
+    X(CheckClient)                  \
+    X(RotateClient)                 \
+    X(RegisterCurrentThread)        \
+    X(WarmThread)                   \
+    X(SetRateLimit)                 \
+    X(SetTxTypeRateLimit)           \
+    X(CanSend)                      \
+    X(GetRateLimitCounters)         \
+    X(CreateCompletionQueue)        \
+    X(CloseCompletionQueue)         \
+    X(SetCompletionQueueMaxAge)     \
+    X(FreeCompletionQueue)          \
+    X(SubmitCreateOrder)            \
+    X(SubmitModifyOrder)            \
+    X(SubmitCancelOrder)            \
+    X(ConfigureTxBatcher)           \
+    X(SendTxBatched)                \
+    X(GetTxBatcherStats)            \
+    X(SignChangePubKey)             \
+    X(SignCreateOrder)              \
+    X(SignCreateGroupedOrders)      \
+    X(SignCancelOrder)              \
+    X(SignWithdraw)                 \
+    X(SignCreateSubAccount)         \
+    X(SignCancelAllOrders)          \
+    X(SignModifyOrder)              \
+    X(SignTransfer)                 \
+    X(SignCreatePublicPool)         \
+    X(SignUpdatePublicPool)         \
+    X(SignMintShares)               \
+    X(SignBurnShares)               \
+    X(SignUpdateLeverage)           \
+    X(CreateAuthToken)              \
+    X(SignUpdateMargin)             \
+    X(SignStakeAssets)              \
+    X(SignUnstakeAssets)            \
+    X(SignApproveIntegrator)        \
+    X(SignUpdateAccountConfig)      \
+    X(SignUpdateAccountAssetConfig) \
+    X(Free)
+
+struct LighterSigner {
+#define LIGHTER_SIGNER_FIELD(name) decltype(&::name) name = nullptr;
+    LIGHTER_SIGNER_EXPORTS(LIGHTER_SIGNER_FIELD)
+#undef LIGHTER_SIGNER_FIELD
+
+    void* handle = nullptr;
+    int amd64Level = 0; // 1, 3 or 4
+};
+
+// lighter_amd64_level returns the highest x86-64 microarchitecture level (1, 3 or 4) supported by both the CPU and the OS.
+// v2 is not built separately, as v3 covers the CPUs it would be picked for.
+inline int lighter_amd64_level() {
+    unsigned int eax, ebx, ecx, edx;
+    if (!__get_cpuid(1, &eax, &ebx, &ecx, &edx)) {
+        return 1;
+    }
+    const bool fma = ecx & (1u << 12), movbe = ecx & (1u << 22), osxsave = ecx & (1u << 27),
+               avx = ecx & (1u << 28), f16c = ecx & (1u << 29), popcnt = ecx & (1u << 23),
+               sse42 = ecx & (1u << 20), ssse3 = ecx & (1u << 9), sse3 = ecx & 1u, cx16 = ecx & (1u << 13);
+    if (!(osxsave && avx)) {
+        return 1;
+    }
+
+    // XCR0: the OS must save the YMM (and for v4 the opmask & ZMM) registers
+    unsigned int xcr0Lo, xcr0Hi;
+    __asm__ volatile("xgetbv" : "=a"(xcr0Lo), "=d"(xcr0Hi) : "c"(0));
+    const bool osYmm = (xcr0Lo & 0x6) == 0x6;
+    const bool osZmm = (xcr0Lo & 0xe6) == 0xe6;
+
+    if (!__get_cpuid_count(7, 0, &eax, &ebx, &ecx, &edx)) {
+        return 1;
+    }
+    const bool bmi1 = ebx & (1u << 3), avx2 = ebx & (1u << 5), bmi2 = ebx & (1u << 8),
+               avx512f = ebx & (1u << 16), avx512dq = ebx & (1u << 17), avx512cd = ebx & (1u << 28),
+               avx512bw = ebx & (1u << 30), avx512vl = ebx & (1u << 31);
+
+    __get_cpuid(0x80000001, &eax, &ebx, &ecx, &edx);
+    const bool lzcnt = ecx & (1u << 5);
+
+    const bool v2 = cx16 && popcnt && sse3 && sse42 && ssse3;
+    const bool v3 = v2 && osYmm && avx2 && bmi1 && bmi2 && f16c && fma && lzcnt && movbe;
+    const bool v4 = v3 && osZmm && avx512f && avx512bw && avx512cd && avx512dq && avx512vl;
+    return v4 ? 4 : (v3 ? 3 : 1);
+}
+
+inline bool lighter_load(LighterSigner& out, const std::string& dir, std::string* err) {
+    int level = lighter_amd64_level();
+    for (; level >= 1; level = level == 3 ? 1 : level - 1) {
+        std::string path = dir + "/lighter-signer-linux-amd64-v" + std::to_string(level) + ".so";
+        out.handle = dlopen(path.c_str(), RTLD_NOW | RTLD_LOCAL);
+        if (out.handle != nullptr) {
+            break;
+        }
+    }
+    if (out.handle == nullptr) {
+        if (err != nullptr) *err = std::string("no library variant could be loaded from ") + dir + ": " + dlerror();
+        return false;
+    }
+    out.amd64Level = level;
+
+#define LIGHTER_SIGNER_RESOLVE(name)                                                      \
+    out.name = reinterpret_cast<decltype(out.name)>(dlsym(out.handle, #name));            \
+    if (out.name == nullptr) {                                                            \
+        if (err != nullptr) *err = std::string("missing symbol ") + #name;                \
+        return false;                                                                     \
+    }
+    LIGHTER_SIGNER_EXPORTS(LIGHTER_SIGNER_RESOLVE)
+#undef LIGHTER_SIGNER_RESOLVE
+
+    return true;
+}
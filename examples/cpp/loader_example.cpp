@@ -0,0 +1,75 @@
+// Loads the best GOAMD64 variant at runtime through lighter_loader.hpp and times the signing path.
+// Build with `just build-cpp-loader`, run from the repo root as `./build/loader-example-cpp`
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include "../../build/lighter-signer-linux-amd64-v1.h"
+#include "lighter_loader.hpp"
+using namespace std;
+
+
+uint64_t now_us() {
+    using namespace std::chrono;
+    return duration_cast<microseconds>(
+        steady_clock::now().time_since_epoch()
+    ).count();
+}
+
+uint64_t now_ms() {
+    using namespace std::chrono;
+    return duration_cast<milliseconds>(
+        system_clock::now().time_since_epoch()
+    ).count();
+}
+
+int main() {
+    LighterSigner signer;
+    string err;
+    if (!lighter_load(signer, "./build", &err)) {
+        cerr << "lighter_load" << '\t' << err << '\n';
+        return 1;
+    }
+    cout << "loaded" << '\t' << "x86-64-v" << signer.amd64Level << '\n';
+
+    int apiKeyIndex = 0;
+    long long accountIndex = 100;
+
+    ApiKeyResponse apiResp = signer.GenerateAPIKey();
+    if (apiResp.err != nullptr) {
+        signer.Free(apiResp.err);
+        return 1;
+    }
+    auto clientErr = signer.CreateClient(nullptr, apiResp.privateKey, 304, apiKeyIndex, accountIndex);
+    signer.Free(apiResp.privateKey);
+    signer.Free(apiResp.publicKey);
+    if (clientErr != nullptr) {
+        cerr << "CreateClient" << '\t' << clientErr << '\n';
+        signer.Free(clientErr);
+        return 1;
+    }
+
+    const int iterations = 10000;
+    long long nonce = 1;
+    auto start = now_us();
+    for (int i = 1; i <= iterations; i += 1) {
+        auto create = signer.SignCreateOrder(
+            0, i, 10000, 400000, true,
+            /* cOrderType */ 0, /* cTimeInForce */ 2, /* cReduceOnly */ 0, /* cTriggerPrice */ 0,
+            now_ms() + 60 * 60 * 1000,
+            /* cIntegratorAccountIndex */ 0,
+            /* cIntegratorTakerFee */ 0,
+            /* cIntegratorMakerFee */ 0,
+            /* cSkipNonce */ 0,
+            nonce++, apiKeyIndex, accountIndex);
+        if (create.err != nullptr) {
+            cerr << "create" << '\t' << create.err << '\n';
+            signer.Free(create.err);
+        }
+        if (create.txInfo != nullptr) signer.Free(create.txInfo);
+        if (create.txHash != nullptr) signer.Free(create.txHash);
+        if (create.messageToSign != nullptr) signer.Free(create.messageToSign);
+    }
+    auto end = now_us();
+    cout << "SignCreateOrder" << '\t' << float(end - start) / iterations << "us/op" << '\n';
+    return 0;
+}
@@ -0,0 +1,109 @@
+// First-call vs steady state latency per thread, with and without pre-warming the threads.
+// Build with `just build-cpp-warmup`, run as `LD_LIBRARY_PATH=./build ./build/warmup-bench-cpp`
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <mutex>
+#include <thread>
+#include <vector>
+#if defined(__APPLE__)
+  #include "../../build/lighter-signer-darwin-arm64.h"
+#elif defined(__linux__)
+  #include "../../build/lighter-signer-linux.h"
+#elif defined(_WIN32)
+  #include "../../build/lighter-signer-windows.h"
+#endif
+using namespace std;
+
+
+const int threads = 5;
+const int steadyIterations = 1000;
+const long long accountIndex = 100;
+
+mutex outMu;
+
+uint64_t now_ns() {
+    using namespace std::chrono;
+    return duration_cast<nanoseconds>(
+        steady_clock::now().time_since_epoch()
+    ).count();
+}
+
+uint64_t sign_cancel(int apiKeyIndex, long long nonce) {
+    auto start = now_ns();
+    auto cancel = SignCancelOrder(0, nonce + 1, /* cSkipNonce */ 0, nonce, apiKeyIndex, accountIndex);
+    auto elapsed = now_ns() - start;
+
+    if (cancel.err != nullptr) {
+        cerr << "cancel" << '\t' << cancel.err << '\n';
+        Free(cancel.err);
+    }
+    if (cancel.txInfo != nullptr) Free(cancel.txInfo);
+    if (cancel.txHash != nullptr) Free(cancel.txHash);
+    if (cancel.messageToSign != nullptr) Free(cancel.messageToSign);
+    return elapsed;
+}
+
+void run_thread(int apiKeyIndex, bool warm) {
+    uint64_t warmElapsed = 0;
+    if (warm) {
+        auto start = now_ns();
+        RegisterCurrentThread();
+        auto err = WarmThread(apiKeyIndex, accountIndex);
+        warmElapsed = now_ns() - start;
+        if (err != nullptr) {
+            cerr << "WarmThread" << '\t' << err << '\n';
+            Free(err);
+        }
+    }
+
+    long long nonce = 1;
+    uint64_t first = sign_cancel(apiKeyIndex, nonce++);
+
+    vector<uint64_t> steady;
+    steady.reserve(steadyIterations);
+    for (int i = 0; i < steadyIterations; i += 1) {
+        steady.push_back(sign_cancel(apiKeyIndex, nonce++));
+    }
+    sort(steady.begin(), steady.end());
+
+    lock_guard<mutex> lock(outMu);
+    cout << (warm ? "warm" : "cold") << '\t' << "thread " << apiKeyIndex
+         << '\t' << "warmup " << warmElapsed / 1000.0 << "us"
+         << '\t' << "first " << first / 1000.0 << "us"
+         << '\t' << "steady p50 " << steady[steady.size() / 2] / 1000.0 << "us" << '\n';
+}
+
+void run_threads(bool warm) {
+    vector<thread> runners;
+    for (int i = 0; i < threads; i += 1) {
+        runners.emplace_back(run_thread, i, warm);
+    }
+    for (auto& t: runners) {
+        t.join();
+    }
+}
+
+int main() {
+    for (int apiKeyIndex = 0; apiKeyIndex < threads; apiKeyIndex += 1) {
+        ApiKeyResponse apiResp = GenerateAPIKey();
+        if (apiResp.err != nullptr) {
+            Free(apiResp.err);
+            return 1;
+        }
+        auto clientErr = CreateClient(nullptr, apiResp.privateKey, 304, apiKeyIndex, accountIndex);
+        Free(apiResp.privateKey);
+        Free(apiResp.publicKey);
+        if (clientErr != nullptr) {
+            cerr << "CreateClient" << '\t' << clientErr << '\n';
+            Free(clientErr);
+            return 1;
+        }
+    }
+
+    // every run uses fresh threads, so both start without a Go M bound to them
+    run_threads(false);
+    run_threads(true);
+    return 0;
+}
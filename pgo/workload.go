@@ -0,0 +1,132 @@
+// Package pgo holds the representative signing workload used to generate the CPU profile
+// (sharedlib/default.pgo) for profile-guided optimized builds of the shared library.
+package pgo
+
+import (
+	"time"
+
+	"github.com/elliottech/lighter-go/client"
+	"github.com/elliottech/lighter-go/types"
+	"github.com/elliottech/lighter-go/types/txtypes"
+)
+
+const (
+	chainId      uint32 = 304
+	accountIndex int64  = 100
+	apiKeyIndex  uint8  = 3
+)
+
+// Workload mirrors the call mix of a market maker going through the sharedlib exports:
+// mostly create / modify / cancel, some grouped orders and the occasional auth token.
+type Workload struct {
+	Client *client.TxClient
+	nonce  int64
+	step   int64
+}
+
+func NewWorkload() (*Workload, error) {
+	privateKey, _, err := client.GenerateAPIKey()
+	if err != nil {
+		return nil, err
+	}
+	c, err := client.NewTxClient(nil, privateKey, accountIndex, apiKeyIndex, chainId)
+	if err != nil {
+		return nil, err
+	}
+	return &Workload{Client: c}, nil
+}
+
+func (w *Workload) ops() *types.TransactOpts {
+	nonce := w.nonce
+	w.nonce++
+	return &types.TransactOpts{Nonce: &nonce}
+}
+
+// encode does the same work as convertTxInfoToResponse in the sharedlib, minus the C strings
+func encode(txInfo txtypes.TxInfo, err error) error {
+	if err != nil {
+		return err
+	}
+	if _, err := txInfo.GetTxInfo(); err != nil {
+		return err
+	}
+	_ = txInfo.GetTxHash()
+	return nil
+}
+
+func (w *Workload) createOrderReq() *types.CreateOrderTxReq {
+	return &types.CreateOrderTxReq{
+		MarketIndex:      0,
+		ClientOrderIndex: w.step%1000 + 1,
+		BaseAmount:       10000,
+		Price:            uint32(400000 + w.step%100),
+		IsAsk:            uint8(w.step % 2),
+		TimeInForce:      txtypes.PostOnly,
+		OrderExpiry:      time.Now().Add(time.Hour).UnixMilli(),
+	}
+}
+
+func (w *Workload) groupedOrdersReq() *types.CreateGroupedOrdersTxReq {
+	expiry := time.Now().Add(time.Hour).UnixMilli()
+	return &types.CreateGroupedOrdersTxReq{
+		GroupingType: txtypes.GroupingType_OneTriggersTheOther,
+		Orders: []*types.CreateOrderTxReq{
+			{MarketIndex: 0, BaseAmount: 1000, Price: 50000, TimeInForce: txtypes.GoodTillTime, OrderExpiry: expiry},
+			{MarketIndex: 0, Price: 51000, IsAsk: 1, Type: txtypes.TakeProfitOrder, TimeInForce: txtypes.ImmediateOrCancel, ReduceOnly: 1, TriggerPrice: 49000, OrderExpiry: expiry},
+		},
+	}
+}
+
+func (w *Workload) CreateOrder() error {
+	return encode(w.Client.GetCreateOrderTransaction(w.createOrderReq(), w.ops()))
+}
+
+func (w *Workload) ModifyOrder() error {
+	return encode(w.Client.GetModifyOrderTransaction(&types.ModifyOrderTxReq{
+		MarketIndex: 0,
+		Index:       w.step%1000 + 1,
+		BaseAmount:  10000,
+		Price:       uint32(400000 + w.step%100),
+	}, w.ops()))
+}
+
+func (w *Workload) CancelOrder() error {
+	return encode(w.Client.GetCancelOrderTransaction(&types.CancelOrderTxReq{
+		MarketIndex: 0,
+		Index:       w.step%1000 + 1,
+	}, w.ops()))
+}
+
+func (w *Workload) CreateGroupedOrders() error {
+	return encode(w.Client.GetCreateGroupedOrdersTransaction(w.groupedOrdersReq(), w.ops()))
+}
+
+func (w *Workload) AuthToken() error {
+	_, err := w.Client.GetAuthToken(time.Now().Add(7 * time.Hour))
+	return err
+}
+
+// Step runs one iteration of the mix: 4 creates, 4 modifies, 4 cancels, 1 grouped order and 1 auth token every 8 steps
+func (w *Workload) Step() error {
+	for i := 0; i < 4; i++ {
+		if err := w.CreateOrder(); err != nil {
+			return err
+		}
+		if err := w.ModifyOrder(); err != nil {
+			return err
+		}
+		if err := w.CancelOrder(); err != nil {
+			return err
+		}
+	}
+	if err := w.CreateGroupedOrders(); err != nil {
+		return err
+	}
+	if w.step%8 == 0 {
+		if err := w.AuthToken(); err != nil {
+			return err
+		}
+	}
+	w.step++
+	return nil
+}
@@ -0,0 +1,92 @@
+package pgo
+
+import "testing"
+
+func newBenchWorkload(b *testing.B) *Workload {
+	b.Helper()
+	w, err := NewWorkload()
+	if err != nil {
+		b.Fatalf("NewWorkload failed: %v", err)
+	}
+	return w
+}
+
+func runBench(b *testing.B, fn func(w *Workload) error) {
+	w := newBenchWorkload(b)
+	b.ReportAllocs()
+	b.ResetTimer()
+	for i := 0; i < b.N; i++ {
+		if err := fn(w); err != nil {
+			b.Fatal(err)
+		}
+	}
+}
+
+// runOpBench benchmarks a single operation of the workload, advancing its step like Step does
+func runOpBench(b *testing.B, fn func(w *Workload) error) {
+	runBench(b, func(w *Workload) error {
+		err := fn(w)
+		w.step++
+		return err
+	})
+}
+
+// BenchmarkWorkload is the profile source for sharedlib/default.pgo (see `just pgo-profile`)
+func BenchmarkWorkload(b *testing.B) {
+	runBench(b, (*Workload).Step)
+}
+
+// The benchmarks below cover the order-flow Sign* exports of sharedlib, and CreateAuthToken.
+// Compare `-pgo=off` against `-pgo=../sharedlib/default.pgo` (see `just bench-pgo`).
+
+func BenchmarkSignCreateOrder(b *testing.B) {
+	runOpBench(b, (*Workload).CreateOrder)
+}
+
+func BenchmarkSignModifyOrder(b *testing.B) {
+	runOpBench(b, (*Workload).ModifyOrder)
+}
+
+func BenchmarkSignCancelOrder(b *testing.B) {
+	runOpBench(b, (*Workload).CancelOrder)
+}
+
+func BenchmarkSignCreateGroupedOrders(b *testing.B) {
+	runOpBench(b, (*Workload).CreateGroupedOrders)
+}
+
+func BenchmarkCreateAuthToken(b *testing.B) {
+	runOpBench(b, (*Workload).AuthToken)
+}
+
+// Hash-only benchmarks, isolating the Poseidon2 path from the Schnorr signature
+
+func BenchmarkHashCreateOrder(b *testing.B) {
+	w := newBenchWorkload(b)
+	tx, err := w.Client.GetCreateOrderTransaction(w.createOrderReq(), w.ops())
+	if err != nil {
+		b.Fatal(err)
+	}
+	b.ReportAllocs()
+	b.ResetTimer()
+	for i := 0; i < b.N; i++ {
+		if _, err := tx.Hash(chainId); err != nil {
+			b.Fatal(err)
+		}
+	}
+}
+
+func BenchmarkHashCreateGroupedOrders(b *testing.B) {
+	w := newBenchWorkload(b)
+	tx, err := w.Client.GetCreateGroupedOrdersTransaction(w.groupedOrdersReq(), w.ops())
+	if err != nil {
+		b.Fatal(err)
+	}
+	b.ReportAllocs()
+	b.ResetTimer()
+	for i := 0; i < b.N; i++ {
+		if _, err := tx.Hash(chainId); err != nil {
+			b.Fatal(err)
+		}
+	}
+}
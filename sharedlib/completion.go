@@ -0,0 +1,395 @@
+package main
+
+import (
+	"errors"
+	"fmt"
+	"sync"
+	"sync/atomic"
+	"time"
+	"unsafe"
+
+	"github.com/elliottech/lighter-go/client"
+	"github.com/elliottech/lighter-go/types"
+)
+
+/*
+#include <stdlib.h>
+#include <stdint.h>
+
+typedef struct {
+	uint64_t requestId;
+	uint8_t txType;
+	uint8_t dropped;    // 1 if the request was still queued at its deadline, 2 if an earlier nonce of its API key was dropped,
+	                    // see SetCompletionQueueMaxAge (err is set too)
+	char* txInfo;
+	char* txHash;
+	char* err;
+} Completion;
+
+// CompletionRing is shared between the library (single producer) and the caller (single consumer).
+// head, tail, closed, signals and signalErrors must be accessed atomically (__atomic_load_n / __atomic_store_n, seq_cst).
+typedef struct {
+	uint64_t head;      // next slot written by the library
+	uint8_t pad0[56];
+	uint64_t tail;      // next slot read by the caller, advanced after a completion was consumed
+	uint8_t pad1[56];
+	uint64_t signals;   // eventfd writes so far, completions per signal shows the coalescing
+	uint64_t dropped;   // requests dropped at their deadline, or behind a dropped nonce, so far
+	uint64_t signalErrors; // failed eventfd writes so far: completions were published but their wake-up was lost
+	uint32_t closed;    // set after the last completion of a closed queue was written
+	uint32_t capacity;  // power of 2
+	int32_t eventFd;
+	int32_t queueId;
+	Completion* slots;
+} CompletionRing;
+
+typedef struct {
+	CompletionRing* ring;
+	char* err;
+} CompletionQueueResponse;
+*/
+import "C"
+
+// completionQueue signs requests through a client.SignPipeline and publishes the results into a ring shared with the caller.
+// The eventfd is only written when the caller has consumed everything before the new completion,
+// so a burst of completions costs a single wake-up.
+type completionQueue struct {
+	ring     *C.CompletionRing
+	mask     uint64
+	pipeline *client.SignPipeline
+	done     chan struct{}
+
+	// requests accepted by Submit*, reserved before submitting so the ring can never overflow
+	submitted atomic.Uint64
+	// nanoseconds after Submit* at which requests are dropped instead of signed, 0 for never
+	maxAge atomic.Int64
+}
+
+var (
+	completionQueuesMu     sync.RWMutex
+	completionQueues       = make(map[int32]*completionQueue)
+	nextCompletionQueueId  int32
+	errCompletionQueueFull = fmt.Errorf("completion queue is full, consume completions first")
+	// nonce -1 would be fetched with a blocking HTTP call, on the thread Submit* exists to keep unblocked
+	errCompletionQueueNonce = fmt.Errorf("Submit* need an explicit nonce, -1 is not supported: fetch the first one with the nextNonce HTTP call")
+)
+
+func (q *completionQueue) head() *uint64    { return (*uint64)(unsafe.Pointer(&q.ring.head)) }
+func (q *completionQueue) tail() *uint64    { return (*uint64)(unsafe.Pointer(&q.ring.tail)) }
+func (q *completionQueue) signals() *uint64 { return (*uint64)(unsafe.Pointer(&q.ring.signals)) }
+func (q *completionQueue) dropped() *uint64 { return (*uint64)(unsafe.Pointer(&q.ring.dropped)) }
+func (q *completionQueue) signalErrors() *uint64 {
+	return (*uint64)(unsafe.Pointer(&q.ring.signalErrors))
+}
+func (q *completionQueue) closed() *uint32 { return (*uint32)(unsafe.Pointer(&q.ring.closed)) }
+
+func (q *completionQueue) slot(i uint64) *C.Completion {
+	slots := unsafe.Slice(q.ring.slots, int(q.ring.capacity))
+	return &slots[i&q.mask]
+}
+
+// publish runs on a single goroutine, until the pipeline is closed and drained
+func (q *completionQueue) publish() {
+	defer close(q.done)
+
+	for res := range q.pipeline.Results() {
+		h := atomic.LoadUint64(q.head())
+		// Submit keeps at most capacity requests outstanding, so the slot is always free
+		slot := q.slot(h)
+		*slot = C.Completion{requestId: C.uint64_t(res.Tag.(uint64))}
+		if res.Err != nil {
+			slot.err = wrapErr(res.Err)
+			switch {
+			case errors.Is(res.Err, client.ErrDeadlineExceeded):
+				slot.dropped = 1
+				atomic.AddUint64(q.dropped(), 1)
+			case errors.Is(res.Err, client.ErrNonceGap):
+				slot.dropped = 2
+				atomic.AddUint64(q.dropped(), 1)
+			}
+		} else {
+			slot.txType = C.uint8_t(res.TxInfo.GetTxType())
+			slot.txInfo = C.CString(res.TxJSON)
+			slot.txHash = C.CString(res.TxInfo.GetTxHash())
+		}
+		atomic.StoreUint64(q.head(), h+1)
+
+		// The caller stores tail after draining and then re-reads head, so either it sees this completion,
+		// or this load sees tail == h and the caller is (about to be) waiting on the eventfd.
+		if atomic.LoadUint64(q.tail()) == h {
+			q.signal()
+		}
+	}
+
+	atomic.StoreUint32(q.closed(), 1)
+	q.signal()
+}
+
+// signal never fails the queue: a lost wake-up is counted in ring->signalErrors, the completions are still published
+func (q *completionQueue) signal() {
+	atomic.AddUint64(q.signals(), 1)
+	if err := writeEventFd(int(q.ring.eventFd)); err != nil {
+		atomic.AddUint64(q.signalErrors(), 1)
+	}
+}
+
+func (q *completionQueue) submit(c *client.TxClient, tx any, ops *types.TransactOpts, requestId uint64) error {
+	if ops.Nonce == nil || *ops.Nonce == -1 {
+		return errCompletionQueueNonce
+	}
+	for {
+		submitted := q.submitted.Load()
+		if submitted-atomic.LoadUint64(q.tail()) >= uint64(q.ring.capacity) {
+			return errCompletionQueueFull
+		}
+		if q.submitted.CompareAndSwap(submitted, submitted+1) {
+			break
+		}
+	}
+
+	req := client.PipelineRequest{Client: c, Tx: tx, Ops: ops, Tag: requestId}
+	if maxAge := q.maxAge.Load(); maxAge > 0 {
+		req.Deadline = time.Now().Add(time.Duration(maxAge))
+	}
+	err := q.pipeline.Submit(req)
+	if err != nil {
+		q.submitted.Add(^uint64(0))
+	}
+	return err
+}
+
+func getCompletionQueue(cQueueId C.int) (*completionQueue, error) {
+	completionQueuesMu.RLock()
+	defer completionQueuesMu.RUnlock()
+	q, ok := completionQueues[int32(cQueueId)]
+	if !ok {
+		return nil, fmt.Errorf("completion queue %v does not exist", int32(cQueueId))
+	}
+	return q, nil
+}
+
+// CreateCompletionQueue creates a queue for asynchronous signing (Submit* exports), with a ring of cCapacity completions
+// (rounded up to a power of 2) and cWorkers goroutines per signing stage (0 = GOMAXPROCS).
+// ring->eventFd is a non-blocking Linux eventfd, readable when new completions were written; register it with epoll.
+// See examples/cpp/lighter_completions.hpp for the consumer side.
+//
+//export CreateCompletionQueue
+func CreateCompletionQueue(cCapacity C.int, cWorkers C.int) (ret C.CompletionQueueResponse) {
+	defer func() {
+		if r := recover(); r != nil {
+			ret = C.CompletionQueueResponse{err: wrapErr(fmt.Errorf("panic: %v", r))}
+		}
+	}()
+
+	if cCapacity <= 0 {
+		return C.CompletionQueueResponse{err: wrapErr("capacity must be positive")}
+	}
+	capacity := uint64(1)
+	for capacity < uint64(cCapacity) {
+		capacity <<= 1
+	}
+
+	fd, err := newEventFd()
+	if err != nil {
+		return C.CompletionQueueResponse{err: wrapErr(err)}
+	}
+
+	ring := (*C.CompletionRing)(C.calloc(1, C.size_t(unsafe.Sizeof(C.CompletionRing{}))))
+	ring.slots = (*C.Completion)(C.calloc(C.size_t(capacity), C.size_t(unsafe.Sizeof(C.Completion{}))))
+	ring.capacity = C.uint32_t(capacity)
+	ring.eventFd = C.int32_t(fd)
+
+	q := &completionQueue{
+		ring:     ring,
+		mask:     capacity - 1,
+		pipeline: client.NewSignPipeline(client.PipelineConfig{Workers: int(cWorkers), MaxInFlight: int(capacity)}),
+		done:     make(chan struct{}),
+	}
+
+	completionQueuesMu.Lock()
+	nextCompletionQueueId++
+	ring.queueId = C.int32_t(nextCompletionQueueId)
+	completionQueues[nextCompletionQueueId] = q
+	completionQueuesMu.Unlock()
+
+	go q.publish()
+	return C.CompletionQueueResponse{ring: ring}
+}
+
+// CloseCompletionQueue stops accepting new requests. Pending requests are still signed and published,
+// then ring->closed is set and the eventfd is signaled one last time.
+//
+//export CloseCompletionQueue
+func CloseCompletionQueue(cQueueId C.int) (ret *C.char) {
+	defer func() {
+		if r := recover(); r != nil {
+			ret = wrapErr(fmt.Errorf("panic: %v", r))
+		}
+	}()
+
+	q, err := getCompletionQueue(cQueueId)
+	if err != nil {
+		return wrapErr(err)
+	}
+	q.pipeline.Close()
+	return nil
+}
+
+// SetCompletionQueueMaxAge makes requests submitted from now on expire cMaxAgeUs microseconds after Submit* (0 = never).
+// Requests still queued when they expire are not signed: their completion has dropped = 1 and the error set,
+// and ring->dropped is incremented. Their nonce is not used, so the requests queued after them for the same API key
+// are not signed either (dropped = 2), until a request with the dropped nonce, or an earlier one, is submitted.
+//
+//export SetCompletionQueueMaxAge
+func SetCompletionQueueMaxAge(cQueueId C.int, cMaxAgeUs C.longlong) (ret *C.char) {
+	defer func() {
+		if r := recover(); r != nil {
+			ret = wrapErr(fmt.Errorf("panic: %v", r))
+		}
+	}()
+
+	q, err := getCompletionQueue(cQueueId)
+	if err != nil {
+		return wrapErr(err)
+	}
+	q.maxAge.Store(max(int64(cMaxAgeUs), 0) * int64(time.Microsecond))
+	return nil
+}
+
+// FreeCompletionQueue releases the ring, the eventfd and the strings of completions which were not consumed.
+// It waits for pending requests, so call it after ring->closed was observed (or after CloseCompletionQueue, when not consuming anymore).
+//
+//export FreeCompletionQueue
+func FreeCompletionQueue(cQueueId C.int) (ret *C.char) {
+	defer func() {
+		if r := recover(); r != nil {
+			ret = wrapErr(fmt.Errorf("panic: %v", r))
+		}
+	}()
+
+	completionQueuesMu.Lock()
+	q, ok := completionQueues[int32(cQueueId)]
+	delete(completionQueues, int32(cQueueId))
+	completionQueuesMu.Unlock()
+	if !ok {
+		return wrapErr(fmt.Errorf("completion queue %v does not exist", int32(cQueueId)))
+	}
+
+	q.pipeline.Close()
+	<-q.done
+
+	for i := atomic.LoadUint64(q.tail()); i < atomic.LoadUint64(q.head()); i++ {
+		slot := q.slot(i)
+		C.free(unsafe.Pointer(slot.txInfo))
+		C.free(unsafe.Pointer(slot.txHash))
+		C.free(unsafe.Pointer(slot.err))
+	}
+	err := closeEventFd(int(q.ring.eventFd))
+	C.free(unsafe.Pointer(q.ring.slots))
+	C.free(unsafe.Pointer(q.ring))
+	return wrapErr(err)
+}
+
+// SubmitCreateOrder queues a CreateOrder for signing. The parameters are the same as for SignCreateOrder;
+// the signed transaction (or the error) is published to the ring with cRequestId.
+// Completions come out in submission order. An error is returned right away if the ring has no room
+// for the completion, the client doesn't exist or cNonce is -1: Submit* never fetch the nonce, which would block
+// the calling thread on an HTTP request. A transaction rejected by the rate limit completes with the error.
+//
+//export SubmitCreateOrder
+func SubmitCreateOrder(cQueueId C.int, cRequestId C.ulonglong, cMarketIndex C.int, cClientOrderIndex C.longlong, cBaseAmount C.longlong, cPrice C.int, cIsAsk C.int, cOrderType C.int, cTimeInForce C.int, cReduceOnly C.int, cTriggerPrice C.int, cOrderExpiry C.longlong, cIntegratorAccountIndex C.longlong, cIntegratorTakerFee C.int, cIntegratorMakerFee C.int, cSkipNonce C.uint8_t, cNonce C.longlong, cApiKeyIndex C.int, cAccountIndex C.longlong) (ret *C.char) {
+	defer func() {
+		if r := recover(); r != nil {
+			ret = wrapErr(fmt.Errorf("panic: %v", r))
+		}
+	}()
+
+	q, err := getCompletionQueue(cQueueId)
+	if err != nil {
+		return wrapErr(err)
+	}
+	c, err := getClient(cApiKeyIndex, cAccountIndex)
+	if err != nil {
+		return wrapErr(err)
+	}
+
+	orderExpiry := int64(cOrderExpiry)
+	if orderExpiry == -1 {
+		orderExpiry = time.Now().Add(time.Hour * 24 * 28).UnixMilli() // 28 days
+	}
+
+	tx := &types.CreateOrderTxReq{
+		MarketIndex:      int16(cMarketIndex),
+		ClientOrderIndex: int64(cClientOrderIndex),
+		BaseAmount:       int64(cBaseAmount),
+		Price:            uint32(cPrice),
+		IsAsk:            uint8(cIsAsk),
+		Type:             uint8(cOrderType),
+		TimeInForce:      uint8(cTimeInForce),
+		ReduceOnly:       uint8(cReduceOnly),
+		TriggerPrice:     uint32(cTriggerPrice),
+		OrderExpiry:      orderExpiry,
+	}
+	ops := getIntegratorTransactOptsAll(cIntegratorAccountIndex, cIntegratorTakerFee, cIntegratorMakerFee, cSkipNonce, cNonce)
+
+	return wrapErr(q.submit(c, tx, ops, uint64(cRequestId)))
+}
+
+// SubmitModifyOrder is the asynchronous version of SignModifyOrder, see SubmitCreateOrder.
+//
+//export SubmitModifyOrder
+func SubmitModifyOrder(cQueueId C.int, cRequestId C.ulonglong, cMarketIndex C.int, cIndex C.longlong, cBaseAmount C.longlong, cPrice C.longlong, cTriggerPrice C.longlong, cIntegratorAccountIndex C.longlong, cIntegratorTakerFee C.int, cIntegratorMakerFee C.int, cSkipNonce C.uint8_t, cNonce C.longlong, cApiKeyIndex C.int, cAccountIndex C.longlong) (ret *C.char) {
+	defer func() {
+		if r := recover(); r != nil {
+			ret = wrapErr(fmt.Errorf("panic: %v", r))
+		}
+	}()
+
+	q, err := getCompletionQueue(cQueueId)
+	if err != nil {
+		return wrapErr(err)
+	}
+	c, err := getClient(cApiKeyIndex, cAccountIndex)
+	if err != nil {
+		return wrapErr(err)
+	}
+
+	tx := &types.ModifyOrderTxReq{
+		MarketIndex:  int16(cMarketIndex),
+		Index:        int64(cIndex),
+		BaseAmount:   int64(cBaseAmount),
+		Price:        uint32(cPrice),
+		TriggerPrice: uint32(cTriggerPrice),
+	}
+	ops := getIntegratorTransactOptsAll(cIntegratorAccountIndex, cIntegratorTakerFee, cIntegratorMakerFee, cSkipNonce, cNonce)
+
+	return wrapErr(q.submit(c, tx, ops, uint64(cRequestId)))
+}
+
+// SubmitCancelOrder is the asynchronous version of SignCancelOrder, see SubmitCreateOrder.
+//
+//export SubmitCancelOrder
+func SubmitCancelOrder(cQueueId C.int, cRequestId C.ulonglong, cMarketIndex C.int, cOrderIndex C.longlong, cSkipNonce C.uint8_t, cNonce C.longlong, cApiKeyIndex C.int, cAccountIndex C.longlong) (ret *C.char) {
+	defer func() {
+		if r := recover(); r != nil {
+			ret = wrapErr(fmt.Errorf("panic: %v", r))
+		}
+	}()
+
+	q, err := getCompletionQueue(cQueueId)
+	if err != nil {
+		return wrapErr(err)
+	}
+	c, err := getClient(cApiKeyIndex, cAccountIndex)
+	if err != nil {
+		return wrapErr(err)
+	}
+
+	tx := &types.CancelOrderTxReq{
+		MarketIndex: int16(cMarketIndex),
+		Index:       int64(cOrderIndex),
+	}
+	ops := getTransactOpts(cSkipNonce, cNonce)
+
+	return wrapErr(q.submit(c, tx, ops, uint64(cRequestId)))
+}
@@ -0,0 +1,28 @@
+package main
+
+import (
+	"syscall"
+	"unsafe"
+)
+
+func newEventFd() (int, error) {
+	fd, _, errno := syscall.Syscall(syscall.SYS_EVENTFD2, 0, syscall.O_NONBLOCK|syscall.O_CLOEXEC, 0)
+	if errno != 0 {
+		return -1, errno
+	}
+	return int(fd), nil
+}
+
+// writeEventFd adds 1 to the eventfd counter. EAGAIN means the counter is saturated, i.e. the caller has a wake-up pending anyway.
+func writeEventFd(fd int) error {
+	one := uint64(1)
+	_, err := syscall.Write(fd, (*[8]byte)(unsafe.Pointer(&one))[:])
+	if err == syscall.EAGAIN {
+		return nil
+	}
+	return err
+}
+
+func closeEventFd(fd int) error {
+	return syscall.Close(fd)
+}
@@ -0,0 +1,17 @@
+//go:build !linux
+
+package main
+
+import "fmt"
+
+func newEventFd() (int, error) {
+	return -1, fmt.Errorf("completion queues need eventfd, which is only available on linux")
+}
+
+func writeEventFd(fd int) error {
+	return nil
+}
+
+func closeEventFd(fd int) error {
+	return nil
+}
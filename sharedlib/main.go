@@ -3,6 +3,7 @@ package main
 import (
 	"encoding/hex"
 	"fmt"
+	"sync"
 	"time"
 	"unsafe"
 
@@ -29,6 +30,22 @@ typedef struct {
 	char* err;
 } SignedTxResponse;
 
+typedef struct {
+	uint64_t admitted;
+	uint64_t overLimit;
+	uint64_t rejected;
+	double tokens;
+	char* err;
+} RateLimitCounters;
+
+typedef struct {
+	uint64_t requests;
+	uint64_t txs;
+	uint64_t failed;
+	int64_t windowUs;
+	char* err;
+} TxBatcherStats;
+
 typedef struct {
 	char* privateKey;
 	char* publicKey;
@@ -193,6 +210,237 @@ func CreateClient(cUrl *C.char, cPrivateKey *C.char, cChainId C.int, cApiKeyInde
 	return wrapErr(err)
 }
 
+// RotateClient replaces the private key of a client created with CreateClient, without blocking concurrent signers.
+// Signatures already in progress finish with the old key. The cached API keys of the account are dropped,
+// so the next CheckClient compares against the server.
+//
+//export RotateClient
+func RotateClient(cUrl *C.char, cPrivateKey *C.char, cChainId C.int, cApiKeyIndex C.int, cAccountIndex C.longlong) (ret *C.char) {
+	defer func() {
+		if r := recover(); r != nil {
+			ret = wrapErr(fmt.Errorf("panic: %v", r))
+		}
+	}()
+
+	url := C.GoString(cUrl)
+	privateKey := C.GoString(cPrivateKey)
+	apiKeyIndex := uint8(cApiKeyIndex)
+	accountIndex := int64(cAccountIndex)
+
+	httpClient := http.NewClient(url)
+
+	_, err := client.RotateClient(httpClient, privateKey, uint32(cChainId), apiKeyIndex, accountIndex, func(old *client.TxClient) {
+		if old.HTTP() != nil {
+			old.HTTP().InvalidateApiKeys(old.GetAccountIndex())
+		}
+	})
+	return wrapErr(err)
+}
+
+// RegisterCurrentThread binds the calling C thread to the Go runtime.
+// The binding is done by cgo on the first call into any export, and is kept until the thread exits,
+// so calling this once when a thread starts moves that cost out of the first signature.
+//
+//export RegisterCurrentThread
+func RegisterCurrentThread() {}
+
+// WarmThread registers the calling thread and signs & encodes a throwaway order with the given client,
+// so the goroutine stack bound to this thread is grown to its steady state size and the signing code is paged in.
+// Nothing is sent, and neither the client's nonces nor its rate limit budget are affected.
+//
+//export WarmThread
+func WarmThread(cApiKeyIndex C.int, cAccountIndex C.longlong) (ret *C.char) {
+	defer func() {
+		if r := recover(); r != nil {
+			ret = wrapErr(fmt.Errorf("panic: %v", r))
+		}
+	}()
+
+	c, err := getClient(cApiKeyIndex, cAccountIndex)
+	if err != nil {
+		return wrapErr(err)
+	}
+
+	return wrapErr(c.WarmUp())
+}
+
+// SetRateLimit sets the weighted token bucket shared by all transactions of a client.
+// With cRejectBeforeSigning, Sign* calls over budget return an error without signing,
+// otherwise they're signed and only counted as over limit.
+//
+//export SetRateLimit
+func SetRateLimit(cCapacity C.double, cRefillPerSecond C.double, cRejectBeforeSigning C.uint8_t, cApiKeyIndex C.int, cAccountIndex C.longlong) (ret *C.char) {
+	defer func() {
+		if r := recover(); r != nil {
+			ret = wrapErr(fmt.Errorf("panic: %v", r))
+		}
+	}()
+
+	c, err := getClient(cApiKeyIndex, cAccountIndex)
+	if err != nil {
+		return wrapErr(err)
+	}
+
+	c.SetRateLimit(client.RateLimit{Capacity: float64(cCapacity), RefillPerSecond: float64(cRefillPerSecond)}, cRejectBeforeSigning != 0)
+	return nil
+}
+
+// SetTxTypeRateLimit sets the weight of a tx type against the client budget and, if cCapacity is positive,
+// a separate token bucket for that tx type alone.
+//
+//export SetTxTypeRateLimit
+func SetTxTypeRateLimit(cTxType C.uint8_t, cWeight C.double, cCapacity C.double, cRefillPerSecond C.double, cApiKeyIndex C.int, cAccountIndex C.longlong) (ret *C.char) {
+	defer func() {
+		if r := recover(); r != nil {
+			ret = wrapErr(fmt.Errorf("panic: %v", r))
+		}
+	}()
+
+	c, err := getClient(cApiKeyIndex, cAccountIndex)
+	if err != nil {
+		return wrapErr(err)
+	}
+
+	c.SetTxTypeRateLimit(uint8(cTxType), float64(cWeight), client.RateLimit{Capacity: float64(cCapacity), RefillPerSecond: float64(cRefillPerSecond)})
+	return nil
+}
+
+// CanSend returns 1 if a transaction of cTxType fits in the current budget, 0 if it doesn't and -1 if the client doesn't exist.
+// No tokens are consumed.
+//
+//export CanSend
+func CanSend(cTxType C.uint8_t, cApiKeyIndex C.int, cAccountIndex C.longlong) (ret C.int) {
+	defer func() {
+		if r := recover(); r != nil {
+			ret = -1
+		}
+	}()
+
+	c, err := getClient(cApiKeyIndex, cAccountIndex)
+	if err != nil {
+		return -1
+	}
+	if c.CanSend(uint8(cTxType)) {
+		return 1
+	}
+	return 0
+}
+
+//export GetRateLimitCounters
+func GetRateLimitCounters(cApiKeyIndex C.int, cAccountIndex C.longlong) (ret C.RateLimitCounters) {
+	defer func() {
+		if r := recover(); r != nil {
+			ret = C.RateLimitCounters{err: wrapErr(fmt.Errorf("panic: %v", r))}
+		}
+	}()
+
+	c, err := getClient(cApiKeyIndex, cAccountIndex)
+	if err != nil {
+		return C.RateLimitCounters{err: wrapErr(err)}
+	}
+
+	counters := c.RateLimitCounters()
+	return C.RateLimitCounters{
+		admitted:  C.uint64_t(counters.Admitted),
+		overLimit: C.uint64_t(counters.OverLimit),
+		rejected:  C.uint64_t(counters.Rejected),
+		tokens:    C.double(counters.Tokens),
+	}
+}
+
+var (
+	txBatchersMu sync.RWMutex
+	txBatchers   = make(map[string]*client.TxBatcher)
+)
+
+// ConfigureTxBatcher creates the batcher used by SendTxBatched for cUrl. An existing batcher for cUrl is closed,
+// after sending its pending transactions. Zero values use the defaults: 50 txs, 1000us & 4 requests in flight.
+//
+//export ConfigureTxBatcher
+func ConfigureTxBatcher(cUrl *C.char, cMaxBatch C.int, cMaxDelayUs C.longlong, cMaxInFlight C.int) (ret *C.char) {
+	defer func() {
+		if r := recover(); r != nil {
+			ret = wrapErr(fmt.Errorf("panic: %v", r))
+		}
+	}()
+
+	url := C.GoString(cUrl)
+	sender, ok := http.NewClient(url).(client.TxSender)
+	if !ok {
+		return wrapErr(fmt.Errorf("invalid url: %q", url))
+	}
+
+	batcher := client.NewTxBatcher(sender, client.BatcherConfig{
+		MaxBatch:    int(cMaxBatch),
+		MaxDelay:    time.Duration(cMaxDelayUs) * time.Microsecond,
+		MaxInFlight: int(cMaxInFlight),
+	})
+
+	txBatchersMu.Lock()
+	old := txBatchers[url]
+	txBatchers[url] = batcher
+	txBatchersMu.Unlock()
+	if old != nil {
+		old.Close()
+	}
+	return nil
+}
+
+func getTxBatcher(cUrl *C.char) (*client.TxBatcher, error) {
+	url := C.GoString(cUrl)
+	txBatchersMu.RLock()
+	defer txBatchersMu.RUnlock()
+	batcher, ok := txBatchers[url]
+	if !ok {
+		return nil, fmt.Errorf("no batcher configured for %q", url)
+	}
+	return batcher, nil
+}
+
+// SendTxBatched sends a signed transaction (txType & txInfo of a Sign* response) through the batcher of cUrl,
+// and returns its tx hash once the request containing it returned.
+// Calls made concurrently from several threads are sent together; a lone call is sent right away.
+//
+//export SendTxBatched
+func SendTxBatched(cUrl *C.char, cTxType C.uint8_t, cTxInfo *C.char) (ret C.StrOrErr) {
+	defer func() {
+		if r := recover(); r != nil {
+			ret = C.StrOrErr{err: wrapErr(fmt.Errorf("panic: %v", r))}
+		}
+	}()
+
+	batcher, err := getTxBatcher(cUrl)
+	if err != nil {
+		return C.StrOrErr{err: wrapErr(err)}
+	}
+	txHash, err := batcher.Send(uint8(cTxType), C.GoString(cTxInfo))
+	if err != nil {
+		return C.StrOrErr{err: wrapErr(err)}
+	}
+	return C.StrOrErr{str: C.CString(txHash)}
+}
+
+//export GetTxBatcherStats
+func GetTxBatcherStats(cUrl *C.char) (ret C.TxBatcherStats) {
+	defer func() {
+		if r := recover(); r != nil {
+			ret = C.TxBatcherStats{err: wrapErr(fmt.Errorf("panic: %v", r))}
+		}
+	}()
+
+	batcher, err := getTxBatcher(cUrl)
+	if err != nil {
+		return C.TxBatcherStats{err: wrapErr(err)}
+	}
+	stats := batcher.Stats()
+	return C.TxBatcherStats{
+		requests: C.uint64_t(stats.Requests),
+		txs:      C.uint64_t(stats.Txs),
+		failed:   C.uint64_t(stats.Failed),
+		windowUs: C.int64_t(stats.Window.Microseconds()),
+	}
+}
+
 //export CheckClient
 func CheckClient(cApiKeyIndex C.int, cAccountIndex C.longlong) (ret *C.char) {
 	defer func() {
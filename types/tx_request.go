@@ -159,13 +159,11 @@ func ConstructAuthToken(key signer.Signer, deadline time.Time, ops *TransactOpts
 	}
 	message := fmt.Sprintf("%v:%v:%v", deadline.Unix(), *ops.FromAccountIndex, *ops.ApiKeyIndex)
 
-	msgInField, err := g.ArrayFromCanonicalLittleEndianBytes([]byte(message))
+	msgHash, err := HashAuthTokenMessage(message)
 	if err != nil {
-		return "", fmt.Errorf("failed to convert bytes to field element. message: %s, error: %w", message, err)
+		return "", err
 	}
 
-	msgHash := p2.HashToQuinticExtension(msgInField).ToLittleEndianBytes()
-
 	signatureBytes, err := key.Sign(msgHash, p2.NewPoseidon2())
 	if err != nil {
 		return "", err
@@ -175,6 +173,15 @@ func ConstructAuthToken(key signer.Signer, deadline time.Time, ops *TransactOpts
 	return fmt.Sprintf("%v:%v", message, signature), err
 }
 
+// HashAuthTokenMessage returns the hash signed in an auth token, for the `deadline:account:apiKey` part of the token
+func HashAuthTokenMessage(message string) ([]byte, error) {
+	msgInField, err := g.ArrayFromCanonicalLittleEndianBytes([]byte(message))
+	if err != nil {
+		return nil, fmt.Errorf("failed to convert bytes to field element. message: %s, error: %w", message, err)
+	}
+	return p2.HashToQuinticExtension(msgInField).ToLittleEndianBytes(), nil
+}
+
 func ConstructL2TxAttributes(attr *L2TxAttributes) txtypes.L2TxAttributes {
 	if attr == nil ||
 		(attr.IntegratorAccountIndex == nil &&
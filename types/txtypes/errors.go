@@ -95,4 +95,5 @@ var (
 	ErrIntegratorFeeInvalidRange                    = fmt.Errorf("Integrator fees are in invalid range")
 	ErrIntegratorAccountIndexRequiredForNonZeroFees = fmt.Errorf("IntegratorAccountIndex should be non-zero when integrator taker fee or maker fee is non-zero")
 	ErrNonceSkipAttributeInvalid                    = fmt.Errorf("Nonce skip attribute is invalid")
+	ErrL1SignatureInvalid                           = fmt.Errorf("L1Sig should be %d hex encoded bytes", L1SignatureLength)
 )
@@ -0,0 +1,157 @@
+package txtypes
+
+import (
+	"fmt"
+	"runtime"
+	"strconv"
+	"sync"
+	"sync/atomic"
+
+	"github.com/ethereum/go-ethereum/common"
+	"github.com/ethereum/go-ethereum/crypto"
+)
+
+// L1SignatureItem is a signed L1 message: the signature body (see GetL1SignatureBody) and the hex encoded L1Sig
+type L1SignatureItem struct {
+	SignatureBody string
+	L1Sig         string
+}
+
+// L1RecoveryResult is the L1 address which signed an item, or why it couldn't be recovered
+type L1RecoveryResult struct {
+	Address common.Address
+	Err     error
+}
+
+// l1RecoveryChunk is the number of items a worker takes at once
+const l1RecoveryChunk = 64
+
+// l1Recoverer holds the buffers reused across items by a single worker
+type l1Recoverer struct {
+	hasher  crypto.KeccakState
+	message []byte
+	hash    [32]byte
+	sig     [L1SignatureLength]byte
+}
+
+func newL1Recoverer() *l1Recoverer {
+	return &l1Recoverer{hasher: crypto.NewKeccakState()}
+}
+
+func (r *l1Recoverer) keccak(data []byte) {
+	r.hasher.Reset()
+	r.hasher.Write(data)
+	_, _ = r.hasher.Read(r.hash[:])
+}
+
+// recover is calculateL1AddressBySignature without allocating for the message hash & signature, and reporting errors.
+// It accepts the same signatures as hexutil.Decode: 0x prefixed, of either case.
+func (r *l1Recoverer) recover(signatureBody, l1Sig string) (common.Address, error) {
+	if len(l1Sig) < 2 || l1Sig[0] != '0' || (l1Sig[1] != 'x' && l1Sig[1] != 'X') {
+		return common.Address{}, ErrL1SignatureInvalid
+	}
+	l1Sig = l1Sig[2:]
+	if len(l1Sig) != 2*L1SignatureLength {
+		return common.Address{}, ErrL1SignatureInvalid
+	}
+	for i := range r.sig {
+		hi, ok1 := fromHexChar(l1Sig[2*i])
+		lo, ok2 := fromHexChar(l1Sig[2*i+1])
+		if !ok1 || !ok2 {
+			return common.Address{}, ErrL1SignatureInvalid
+		}
+		r.sig[i] = hi<<4 | lo
+	}
+	// Transform yellow paper V from 27/28 to 0/1
+	if r.sig[64] >= 27 {
+		r.sig[64] -= 27
+	}
+
+	// accounts.TextHash
+	r.message = append(r.message[:0], "\x19Ethereum Signed Message:\n"...)
+	r.message = strconv.AppendInt(r.message, int64(len(signatureBody)), 10)
+	r.message = append(r.message, signatureBody...)
+	r.keccak(r.message)
+
+	pubKey, err := crypto.Ecrecover(r.hash[:], r.sig[:])
+	if err != nil {
+		return common.Address{}, fmt.Errorf("failed to recover L1 public key: %w", err)
+	}
+
+	// crypto.PubkeyToAddress: the last 20 bytes of the hash of the uncompressed key, without the 0x04 prefix
+	r.keccak(pubKey[1:])
+	var address common.Address
+	copy(address[:], r.hash[12:])
+	return address, nil
+}
+
+func fromHexChar(c byte) (byte, bool) {
+	switch {
+	case '0' <= c && c <= '9':
+		return c - '0', true
+	case 'a' <= c && c <= 'f':
+		return c - 'a' + 10, true
+	case 'A' <= c && c <= 'F':
+		return c - 'A' + 10, true
+	}
+	return 0, false
+}
+
+// recoverL1Addresses splits [0, n) in chunks which are picked up by `workers` goroutines (GOMAXPROCS if not positive).
+func recoverL1Addresses(n int, workers int, item func(i int) (signatureBody, l1Sig string)) []L1RecoveryResult {
+	results := make([]L1RecoveryResult, n)
+	if workers <= 0 {
+		workers = runtime.GOMAXPROCS(0)
+	}
+	if maxWorkers := (n + l1RecoveryChunk - 1) / l1RecoveryChunk; workers > maxWorkers {
+		workers = maxWorkers
+	}
+
+	var (
+		next atomic.Int64
+		wg   sync.WaitGroup
+	)
+	for w := 0; w < workers; w++ {
+		wg.Add(1)
+		go func() {
+			defer wg.Done()
+			r := newL1Recoverer()
+			for {
+				start := int(next.Add(l1RecoveryChunk)) - l1RecoveryChunk
+				if start >= n {
+					return
+				}
+				end := min(start+l1RecoveryChunk, n)
+				for i := start; i < end; i++ {
+					results[i].Address, results[i].Err = r.recover(item(i))
+				}
+			}
+		}()
+	}
+	wg.Wait()
+	return results
+}
+
+// RecoverL1Addresses recovers the L1 signer of every item in parallel, over `workers` goroutines (GOMAXPROCS if not positive).
+// Results are in the same order as items; unlike GetL1AddressBySignature, invalid signatures are reported in Err
+// instead of resulting in the zero address.
+func RecoverL1Addresses(items []L1SignatureItem, workers int) []L1RecoveryResult {
+	return recoverL1Addresses(len(items), workers, func(i int) (string, string) {
+		return items[i].SignatureBody, items[i].L1Sig
+	})
+}
+
+// RecoverTransferL1Addresses is the batch version of L2TransferTxInfo.GetL1AddressBySignature, see RecoverL1Addresses.
+// Signature bodies are built by the workers too.
+func RecoverTransferL1Addresses(txs []*L2TransferTxInfo, chainId uint32, workers int) []L1RecoveryResult {
+	return recoverL1Addresses(len(txs), workers, func(i int) (string, string) {
+		return txs[i].GetL1SignatureBody(chainId), txs[i].L1Sig
+	})
+}
+
+// RecoverChangePubKeyL1Addresses is the batch version of L2ChangePubKeyTxInfo.GetL1AddressBySignature, see RecoverL1Addresses.
+func RecoverChangePubKeyL1Addresses(txs []*L2ChangePubKeyTxInfo, workers int) []L1RecoveryResult {
+	return recoverL1Addresses(len(txs), workers, func(i int) (string, string) {
+		return txs[i].GetL1SignatureBody(), txs[i].L1Sig
+	})
+}
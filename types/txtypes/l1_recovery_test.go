@@ -0,0 +1,115 @@
+package txtypes
+
+import (
+	"crypto/ecdsa"
+	"errors"
+	"fmt"
+	"testing"
+
+	"github.com/ethereum/go-ethereum/accounts"
+	"github.com/ethereum/go-ethereum/common"
+	"github.com/ethereum/go-ethereum/common/hexutil"
+	"github.com/ethereum/go-ethereum/crypto"
+)
+
+func signL1(tb testing.TB, key *ecdsa.PrivateKey, body string) string {
+	tb.Helper()
+	sig, err := crypto.Sign(accounts.TextHash([]byte(body)), key)
+	if err != nil {
+		tb.Fatal(err)
+	}
+	sig[64] += 27
+	return hexutil.Encode(sig)
+}
+
+func newSignedTransfers(tb testing.TB, n int, chainId uint32) ([]*L2TransferTxInfo, common.Address) {
+	tb.Helper()
+	key, err := crypto.GenerateKey()
+	if err != nil {
+		tb.Fatal(err)
+	}
+	txs := make([]*L2TransferTxInfo, n)
+	for i := range txs {
+		txs[i] = &L2TransferTxInfo{FromAccountIndex: 100, ToAccountIndex: 101, Amount: int64(i + 1), Nonce: int64(i)}
+		txs[i].L1Sig = signL1(tb, key, txs[i].GetL1SignatureBody(chainId))
+	}
+	return txs, crypto.PubkeyToAddress(key.PublicKey)
+}
+
+func TestRecoverTransferL1Addresses(t *testing.T) {
+	const chainId = 304
+	txs, address := newSignedTransfers(t, 300, chainId)
+	txs[7].L1Sig = "0x1234"
+	txs[8].L1Sig = "0x" + txs[8].L1Sig[4:] + "zz"
+
+	results := RecoverTransferL1Addresses(txs, chainId, 4)
+	for i, res := range results {
+		switch i {
+		case 7, 8:
+			if !errors.Is(res.Err, ErrL1SignatureInvalid) {
+				t.Errorf("item %d: err = %v, want ErrL1SignatureInvalid", i, res.Err)
+			}
+		default:
+			if res.Err != nil || res.Address != address {
+				t.Errorf("item %d: %s, %v, want %s", i, res.Address.Hex(), res.Err, address.Hex())
+			}
+			if single := txs[i].GetL1AddressBySignature(chainId); single != res.Address {
+				t.Errorf("item %d: batch %s, single %s", i, res.Address.Hex(), single.Hex())
+			}
+		}
+	}
+}
+
+// malformed signatures are refused by the batch path exactly when the single path yields the zero address
+func TestRecoverL1AddressesMatchSingle(t *testing.T) {
+	const chainId = 304
+	txs, _ := newSignedTransfers(t, 1, chainId)
+	valid := txs[0].L1Sig
+	for _, sig := range []string{
+		valid,
+		valid[2:],                    // no 0x prefix
+		"0x" + valid[4:],             // too short
+		valid + "00",                 // too long
+		"0x" + valid[2:len(valid)-1], // odd length
+		valid[:len(valid)-2] + "zz",  // not hex
+		"", "0x", "0x1234",
+	} {
+		tx := *txs[0]
+		tx.L1Sig = sig
+		res := RecoverTransferL1Addresses([]*L2TransferTxInfo{&tx}, chainId, 1)[0]
+		single := tx.GetL1AddressBySignature(chainId)
+		if (res.Err != nil) != (single == common.Address{}) || res.Address != single {
+			t.Errorf("%q: batch %s, %v; single %s", sig, res.Address.Hex(), res.Err, single.Hex())
+		}
+	}
+}
+
+func BenchmarkRecoverL1AddressSingle(b *testing.B) {
+	const chainId = 304
+	txs, _ := newSignedTransfers(b, 1024, chainId)
+	b.ReportAllocs()
+	b.ResetTimer()
+	for i := 0; i < b.N; i++ {
+		txs[i%len(txs)].GetL1AddressBySignature(chainId)
+	}
+}
+
+// BenchmarkRecoverTransferL1Addresses reports the time per transfer, so it's directly comparable with the single version
+func BenchmarkRecoverTransferL1Addresses(b *testing.B) {
+	const chainId = 304
+	txs, _ := newSignedTransfers(b, 4096, chainId)
+	for _, workers := range []int{1, 2, 4, 8, 0} {
+		b.Run(fmt.Sprintf("workers=%d", workers), func(b *testing.B) {
+			b.ReportAllocs()
+			b.ResetTimer()
+			for done := 0; done < b.N; done += len(txs) {
+				batch := txs[:min(len(txs), b.N-done)]
+				for _, res := range RecoverTransferL1Addresses(batch, chainId, workers) {
+					if res.Err != nil {
+						b.Fatal(res.Err)
+					}
+				}
+			}
+		})
+	}
+}